@@ -0,0 +1,189 @@
+/************************************************************************************
+
+Filename    :   Bench_CommandQueue.cpp
+Content     :   ThreadCommandQueue push/pop throughput with one consumer thread
+                and several producers.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_ThreadCommandQueue.h"
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace OVR;
+
+// Usage: bench_command_queue [producers] [async|wait] [commands] [capacity]
+//
+// Each producer pushes 'commands' calls. 'async' uses PushCall, which returns
+// once the command is queued and blocks only while the queue is full; 'wait'
+// uses PushCallAndWaitResult, which returns after the consumer has run it.
+// The consumer sleeps on an Event while the queue is empty, the way
+// DeviceManagerThread does.
+
+//-------------------------------------------------------------------------------------
+// ***** Queue
+
+class BenchQueue : public ThreadCommandQueue
+{
+public:
+    BenchQueue(UPInt capacity) : ThreadCommandQueue(capacity), Sum(0), Executed(0) { }
+
+    virtual void OnPushNonEmpty_Locked() { CommandEvent.SetEvent(); }
+    virtual void OnPopEmpty_Locked()     { CommandEvent.ResetEvent(); }
+
+    // Commands; only called on the consumer thread.
+    bool Add(int value)       { Sum += value; Executed++; return true; }
+    int  Increment(int value) { Executed++; return value + 1; }
+
+    Event   CommandEvent;
+    UInt64  Sum;
+    UInt64  Executed;
+};
+
+struct ProducerContext
+{
+    BenchQueue* pQueue;
+    bool        Wait;
+    unsigned    Commands;
+    unsigned    Failed;
+};
+
+static int producerThread(Thread*, void* h)
+{
+    ProducerContext* context = (ProducerContext*)h;
+    BenchQueue*      queue   = context->pQueue;
+
+    for (unsigned i = 0; i < context->Commands; i++)
+    {
+        bool pushed;
+        if (context->Wait)
+        {
+            int result = 0;
+            pushed = queue->PushCallAndWaitResult(&BenchQueue::Increment, &result, (int)i) &&
+                     (result == (int)i + 1);
+        }
+        else
+        {
+            pushed = queue->PushCall(&BenchQueue::Add, 1);
+        }
+        if (!pushed)
+            context->Failed++;
+    }
+    return 0;
+}
+
+static int consumerThread(Thread*, void* h)
+{
+    BenchQueue*              queue = (BenchQueue*)h;
+    ThreadCommand::PopBuffer command;
+
+    while (!queue->IsExiting())
+    {
+        if (queue->PopCommand(&command))
+            command.Execute();
+        else
+            queue->CommandEvent.Wait();
+    }
+    return 0;
+}
+
+static void waitFor(Thread* thread)
+{
+    while (!thread->IsFinished())
+        Thread::MSleep(1);
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Benchmark
+
+int main(int argc, char** argv)
+{
+    int      producers = 1;
+    bool     wait      = false;
+    unsigned commands  = 0;
+    unsigned capacity  = ThreadCommandQueue::DefaultCapacity;
+
+    if (argc > 1)
+        producers = atoi(argv[1]);
+    if (argc > 2)
+        wait = !strcmp(argv[2], "wait");
+    if (argc > 3)
+        commands = (unsigned)atoi(argv[3]);
+    if (argc > 4)
+        capacity = (unsigned)atoi(argv[4]);
+    if (!commands)
+        commands = wait ? 100000 : 1000000;
+
+    if (producers < 1 || capacity < 1)
+    {
+        printf("Usage: %s [producers] [async|wait] [commands] [capacity]\n", argv[0]);
+        return 1;
+    }
+
+    System::Init();
+    int result = 0;
+    {
+        BenchQueue*       queue    = new BenchQueue(capacity);
+        ProducerContext*  contexts = new ProducerContext[producers];
+        Array<Ptr<Thread> > threads;
+
+        double start = Timer::GetSeconds();
+
+        Ptr<Thread> consumer = *new Thread(consumerThread, queue);
+        consumer->Start();
+        for (int i = 0; i < producers; i++)
+        {
+            contexts[i].pQueue   = queue;
+            contexts[i].Wait     = wait;
+            contexts[i].Commands = commands;
+            contexts[i].Failed   = 0;
+            Ptr<Thread> thread = *new Thread(producerThread, &contexts[i]);
+            thread->Start();
+            threads.PushBack(thread);
+        }
+
+        for (UPInt i = 0; i < threads.GetSize(); i++)
+            waitFor(threads[i]);
+        queue->PushExitCommand(true);
+        waitFor(consumer);
+
+        double elapsed = Timer::GetSeconds() - start;
+        UInt64 total   = UInt64(producers) * commands;
+
+        unsigned failed = 0;
+        for (int i = 0; i < producers; i++)
+            failed += contexts[i].Failed;
+
+        printf("%d producer(s), %s, capacity %u: %7.1f ns/command, %u cores\n",
+               producers, wait ? "wait" : "async", capacity,
+               elapsed * 1e9 / double(total), (unsigned)Thread::GetCPUCount());
+
+        if (failed || queue->Executed != total || (!wait && queue->Sum != total))
+        {
+            printf("Executed %u of %u commands, %u pushes failed\n",
+                   (unsigned)queue->Executed, (unsigned)total, failed);
+            result = 1;
+        }
+
+        threads.Clear();
+        consumer.Clear();
+        delete[] contexts;
+        delete queue;
+    }
+    System::Destroy();
+    return result;
+}
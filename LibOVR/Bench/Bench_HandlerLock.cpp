@@ -0,0 +1,237 @@
+/************************************************************************************
+
+Filename    :   Bench_HandlerLock.cpp
+Content     :   Contention between sensor message delivery and threads that take
+                MessageHandler::GetHandlerLock, on simulated trackers.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR.h"
+#include "OVR_Sim_DeviceManager.h"
+#include "OVR_Sim_HIDDevice.h"
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace OVR;
+
+// Usage: bench_handler_lock [sensors] [readers] [seconds] [rateHz] [--one-handler]
+//
+// Plugs in 'sensors' simulated trackers sending 'rateHz' reports each, gives
+// each its own MessageHandler, and starts 'readers' threads that repeatedly
+// lock a handler's GetHandlerLock, as code synchronizing with OnMessage does.
+// Reader i uses handler i % sensors. With --one-handler every tracker delivers
+// to one handler, which is how all handlers behaved under the old global lock.
+//
+// Delivery for every simulated tracker runs on the one manager thread, so the
+// frame rate shows how much readers hold that thread up. Handlers take locks
+// from a pool of SharedLock::LockCount; past that, handlers share locks again.
+
+//-------------------------------------------------------------------------------------
+// ***** Handlers and readers
+
+// Counts the frames it is sent, spending a little time on each batch like a
+// fusion update would.
+class CountingHandler : public MessageHandler
+{
+public:
+    CountingHandler() : Frames(0), Work(0) { }
+    ~CountingHandler() { RemoveHandlerFromDevices(); }
+
+    virtual void OnMessage(const Message& msg)
+    {
+        if (msg.Type != Message_BodyFrameBatch)
+            return;
+        const MessageBodyFrameBatch& batch = static_cast<const MessageBodyFrameBatch&>(msg);
+        for (unsigned i = 0; i < batch.FrameCount; i++)
+            Work += batch.Frames[i].Acceleration.y;
+        Frames += batch.FrameCount;
+    }
+
+    virtual bool SupportsMessageType(MessageType type) const
+    {
+        return type == Message_BodyFrameBatch;
+    }
+
+    // Written under the handler lock.
+    UInt64 Frames;
+    float  Work;
+};
+
+struct ReaderContext
+{
+    CountingHandler*        pHandler;
+    volatile bool*          pStop;
+    UInt64                  Reads;
+    UInt64                  FramesSeen;
+};
+
+static int readerThread(Thread*, void* h)
+{
+    ReaderContext* context = (ReaderContext*)h;
+
+    while (!*context->pStop)
+    {
+        Lock::Locker lockScope(context->pHandler->GetHandlerLock());
+        context->FramesSeen = context->pHandler->Frames;
+        context->Reads++;
+    }
+    return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Benchmark
+
+int main(int argc, char** argv)
+{
+    int      sensors    = 4;
+    int      readers    = 4;
+    unsigned seconds    = 2;
+    unsigned rateHz     = 1000;
+    bool     oneHandler = false;
+    int      position   = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--one-handler"))
+        {
+            oneHandler = true;
+            continue;
+        }
+        switch (position++)
+        {
+        case 0: sensors = atoi(argv[i]);           break;
+        case 1: readers = atoi(argv[i]);           break;
+        case 2: seconds = (unsigned)atoi(argv[i]); break;
+        case 3: rateHz  = (unsigned)atoi(argv[i]); break;
+        }
+    }
+    if (sensors < 1 || readers < 0 || seconds < 1 || rateHz < 1)
+    {
+        printf("Usage: %s [sensors] [readers] [seconds] [rateHz] [--one-handler]\n", argv[0]);
+        return 1;
+    }
+
+    System::Init(Log::ConfigureDefaultLog(LogMask_None));
+    int result = 0;
+    {
+        Ptr<Sim::DeviceManager> manager = *Sim::DeviceManager::Create();
+
+        Sim::HIDDeviceConfig config;
+        config.ReportRateHz = rateHz;
+        for (int i = 0; i < sensors; i++)
+            manager->AddDevice(config);
+
+        Array<Ptr<SensorDevice> > devices;
+        for (DeviceEnumerator<SensorDevice> e = manager->EnumerateDevices<SensorDevice>(); e; e.Next())
+        {
+            Ptr<SensorDevice> device = *e.CreateDevice();
+            if (device)
+                devices.PushBack(device);
+        }
+
+        int               handlerCount = oneHandler ? 1 : sensors;
+        CountingHandler*  handlers     = new CountingHandler[handlerCount];
+        ReaderContext*    contexts     = new ReaderContext[readers];
+        Array<Ptr<Thread> > threads;
+        volatile bool     stop         = false;
+
+        // Handlers past the pool size share locks.
+        Array<Lock*> locks;
+        for (int i = 0; i < handlerCount; i++)
+        {
+            Lock* lock = handlers[i].GetHandlerLock();
+            bool  found = false;
+            for (UPInt j = 0; j < locks.GetSize(); j++)
+                found = found || (locks[j] == lock);
+            if (!found)
+                locks.PushBack(lock);
+        }
+
+        for (UPInt i = 0; i < devices.GetSize(); i++)
+            devices[i]->SetMessageHandler(&handlers[i % handlerCount]);
+
+        for (int i = 0; i < readers; i++)
+        {
+            contexts[i].pHandler   = &handlers[i % handlerCount];
+            contexts[i].pStop      = &stop;
+            contexts[i].Reads      = 0;
+            contexts[i].FramesSeen = 0;
+            Ptr<Thread> thread = *new Thread(readerThread, &contexts[i]);
+            thread->Start();
+            threads.PushBack(thread);
+        }
+
+        // Let streams settle before counting.
+        Thread::MSleep(200);
+        UInt64 framesStart = 0;
+        for (int i = 0; i < handlerCount; i++)
+        {
+            Lock::Locker lockScope(handlers[i].GetHandlerLock());
+            framesStart += handlers[i].Frames;
+        }
+        UInt64 readsStart = 0;
+        for (int i = 0; i < readers; i++)
+            readsStart += contexts[i].Reads;
+        double start = Timer::GetSeconds();
+
+        Thread::MSleep(seconds * 1000);
+
+        UInt64 frames = 0;
+        for (int i = 0; i < handlerCount; i++)
+        {
+            Lock::Locker lockScope(handlers[i].GetHandlerLock());
+            frames += handlers[i].Frames;
+        }
+        UInt64 reads = 0;
+        for (int i = 0; i < readers; i++)
+            reads += contexts[i].Reads;
+        double elapsed = Timer::GetSeconds() - start;
+
+        stop = true;
+        for (UPInt i = 0; i < threads.GetSize(); i++)
+            while (!threads[i]->IsFinished())
+                Thread::MSleep(1);
+
+        // Trackers sample at 1 kHz; faster report rates still carry one sample each.
+        double expected = double(devices.GetSize()) * (rateHz > 1000 ? rateHz : 1000);
+
+        printf("%u trackers at %u Hz, %d handlers on %u locks, %d readers, %u cores\n",
+               (unsigned)devices.GetSize(), rateHz, handlerCount, (unsigned)locks.GetSize(),
+               readers, (unsigned)Thread::GetCPUCount());
+        printf("    frames  %10.0f /s  (%.0f%% of the %.0f sent)\n",
+               (frames - framesStart) / elapsed, 100.0 * (frames - framesStart) / elapsed / expected,
+               expected);
+        printf("    reads   %10.0f /s\n", (reads - readsStart) / elapsed);
+        if (readers >= Thread::GetCPUCount())
+            printf("    no core is left free of readers; lost frames include CPU time, not only lock waits\n");
+
+        if ((int)devices.GetSize() != sensors)
+        {
+            printf("Only %u of %d trackers opened\n", (unsigned)devices.GetSize(), sensors);
+            result = 1;
+        }
+
+        for (UPInt i = 0; i < devices.GetSize(); i++)
+            devices[i]->SetMessageHandler(0);
+        devices.Clear();
+        threads.Clear();
+        delete[] contexts;
+        delete[] handlers;
+    }
+    System::Destroy();
+    return result;
+}
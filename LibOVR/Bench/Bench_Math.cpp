@@ -0,0 +1,301 @@
+/************************************************************************************
+
+Filename    :   Bench_Math.cpp
+Content     :   Times the Matrix4f/Quatf kernels against the generic code they
+                replaced, and checks that they give the same results.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace OVR;
+
+//-------------------------------------------------------------------------------------
+// ***** Reference
+
+// The generic Matrix4f/Quatf code from before the SSE kernels, kept here so
+// that both can be timed in one build.
+
+namespace Reference {
+
+static void Multiply(Matrix4f* d, const Matrix4f& a, const Matrix4f& b)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        d->M[i][0] = a.M[i][0] * b.M[0][0] + a.M[i][1] * b.M[1][0] + a.M[i][2] * b.M[2][0] + a.M[i][3] * b.M[3][0];
+        d->M[i][1] = a.M[i][0] * b.M[0][1] + a.M[i][1] * b.M[1][1] + a.M[i][2] * b.M[2][1] + a.M[i][3] * b.M[3][1];
+        d->M[i][2] = a.M[i][0] * b.M[0][2] + a.M[i][1] * b.M[1][2] + a.M[i][2] * b.M[2][2] + a.M[i][3] * b.M[3][2];
+        d->M[i][3] = a.M[i][0] * b.M[0][3] + a.M[i][1] * b.M[1][3] + a.M[i][2] * b.M[2][3] + a.M[i][3] * b.M[3][3];
+    }
+}
+
+static float SubDet(const Matrix4f& m, const int* rows, const int* cols)
+{
+    return m.M[rows[0]][cols[0]] * (m.M[rows[1]][cols[1]] * m.M[rows[2]][cols[2]] - m.M[rows[1]][cols[2]] * m.M[rows[2]][cols[1]])
+         - m.M[rows[0]][cols[1]] * (m.M[rows[1]][cols[0]] * m.M[rows[2]][cols[2]] - m.M[rows[1]][cols[2]] * m.M[rows[2]][cols[0]])
+         + m.M[rows[0]][cols[2]] * (m.M[rows[1]][cols[0]] * m.M[rows[2]][cols[1]] - m.M[rows[1]][cols[1]] * m.M[rows[2]][cols[0]]);
+}
+
+static float Cofactor(const Matrix4f& m, int I, int J)
+{
+    static const int indices[4][3] = {{1,2,3},{0,2,3},{0,1,3},{0,1,2}};
+    return ((I+J)&1) ? -SubDet(m, indices[I], indices[J]) : SubDet(m, indices[I], indices[J]);
+}
+
+static Matrix4f Inverted(const Matrix4f& m)
+{
+    float det = m.M[0][0] * Cofactor(m,0,0) + m.M[0][1] * Cofactor(m,0,1) +
+                m.M[0][2] * Cofactor(m,0,2) + m.M[0][3] * Cofactor(m,0,3);
+    float s   = 1.0f / det;
+    Matrix4f r(Matrix4f::NoInit);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            r.M[i][j] = Cofactor(m, j, i) * s;
+    return r;
+}
+
+static Quatf QuatMultiply(const Quatf& a, const Quatf& b)
+{
+    return Quatf(a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                 a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                 a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                 a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+}
+
+static Vector3f Rotate(const Quatf& q, const Vector3f& v)
+{
+    Quatf r = QuatMultiply(QuatMultiply(q, Quatf(v.x, v.y, v.z, 0)), Quatf(-q.x, -q.y, -q.z, q.w));
+    return Vector3f(r.x, r.y, r.z);
+}
+
+} // namespace Reference
+
+
+//-------------------------------------------------------------------------------------
+// ***** Benchmark
+
+enum { OperandCount = 1024 };
+
+static Matrix4f Matrices[OperandCount];
+static Quatf    Quats[OperandCount];
+static Vector3f Vectors[OperandCount];
+
+// Timed results are stored whole, and each pass uses different operand pairs,
+// so none of the work can be optimized away.
+static Matrix4f MatrixResults[OperandCount];
+static Quatf    QuatResults[OperandCount];
+static Vector3f VectorResults[OperandCount];
+
+// Called after every pass with the results it wrote, so that the compiler
+// keeps every pass's stores instead of only the last pass's, or none.
+static inline void endPass(const void* results)
+{
+#if defined(__GNUC__)
+    __asm__ __volatile__("" : : "r"(results) : "memory");
+#else
+    OVR_UNUSED(results);
+#endif
+}
+
+static int      Iterations = 20000;
+static unsigned Mismatches = 0;
+
+static double perOp(double start, int iterations)
+{
+    return (Timer::GetProfileSeconds() - start) * 1e9 / (double(OperandCount) * iterations);
+}
+
+static void report(const char* name, double refNs, double newNs, const char* check)
+{
+    printf("    %-20s %7.2fns  %7.2fns  x%-5.2f %s\n", name, refNs, newNs, refNs / newNs, check);
+}
+
+static void initOperands()
+{
+    srand(1);
+    for (int i = 0; i < OperandCount; i++)
+    {
+        Vector3f axis(float(rand() % 100 - 50), float(rand() % 100 - 50), float(rand() % 100 + 1));
+        Quats[i]    = Quatf(axis.Normalized(), (rand() % 1000) / 200.0f);
+        Matrices[i] = Matrix4f(Quats[i]) * Matrix4f::Translation(i * 0.1f, 1.0f, 2.0f);
+        Vectors[i]  = Vector3f(i * 0.3f, 1.0f, -i * 0.2f);
+    }
+}
+
+static void benchMultiply()
+{
+    Matrix4f r(Matrix4f::NoInit), rr(Matrix4f::NoInit);
+    unsigned bad = 0;
+
+    for (int i = 0; i < OperandCount; i++)
+    {
+        const Matrix4f& b = Matrices[(i + 1) & (OperandCount - 1)];
+        Matrix4f::Multiply(&r, Matrices[i], b);
+        Reference::Multiply(&rr, Matrices[i], b);
+        if (memcmp(&r, &rr, sizeof(r)))
+            bad++;
+    }
+
+    double start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            Reference::Multiply(&MatrixResults[i], Matrices[i], Matrices[(i + k) & (OperandCount - 1)]);
+        endPass(MatrixResults);
+    }
+    double refNs = perOp(start, Iterations);
+
+    start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            Matrix4f::Multiply(&MatrixResults[i], Matrices[i], Matrices[(i + k) & (OperandCount - 1)]);
+        endPass(MatrixResults);
+    }
+    report("Matrix4f::Multiply", refNs, perOp(start, Iterations), bad ? "MISMATCH" : "exact");
+    Mismatches += bad;
+}
+
+static void benchInverted()
+{
+    // Inverted regroups the cofactor sums, so results may differ in the last
+    // bits; report the largest difference relative to the matrix.
+    float maxError = 0;
+    int   iterations = Iterations / 10;
+
+    for (int i = 0; i < OperandCount; i++)
+    {
+        Matrix4f r  = Matrices[i].Inverted();
+        Matrix4f rr = Reference::Inverted(Matrices[i]);
+        float    scale = 0;
+        for (int j = 0; j < 16; j++)
+            scale = Alg::Max(scale, fabsf((&rr.M[0][0])[j]));
+        for (int j = 0; j < 16; j++)
+            maxError = Alg::Max(maxError, fabsf((&r.M[0][0])[j] - (&rr.M[0][0])[j]) / scale);
+    }
+
+    double start = Timer::GetProfileSeconds();
+    for (int k = 0; k < iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            MatrixResults[i] = Reference::Inverted(Matrices[(i + k) & (OperandCount - 1)]);
+        endPass(MatrixResults);
+    }
+    double refNs = perOp(start, iterations);
+
+    start = Timer::GetProfileSeconds();
+    for (int k = 0; k < iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            MatrixResults[i] = Matrices[(i + k) & (OperandCount - 1)].Inverted();
+        endPass(MatrixResults);
+    }
+
+    char check[32];
+    OVR_sprintf(check, sizeof(check), "max error %.2g", maxError);
+    report("Matrix4f::Inverted", refNs, perOp(start, iterations), check);
+    if (maxError > 1e-5f)
+        Mismatches++;
+}
+
+static void benchQuats()
+{
+    unsigned badMul = 0, badRotate = 0;
+
+    for (int i = 0; i < OperandCount; i++)
+    {
+        const Quatf& b  = Quats[(i + 3) & (OperandCount - 1)];
+        Quatf        p  = Quats[i] * b;
+        Quatf        pp = Reference::QuatMultiply(Quats[i], b);
+        if (memcmp(&p, &pp, sizeof(p)))
+            badMul++;
+
+        Vector3f v  = Quats[i].Rotate(Vectors[i]);
+        Vector3f vv = Reference::Rotate(Quats[i], Vectors[i]);
+        if (memcmp(&v, &vv, sizeof(v)))
+            badRotate++;
+    }
+
+    double start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            QuatResults[i] = Reference::QuatMultiply(Quats[i], Quats[(i + k) & (OperandCount - 1)]);
+        endPass(QuatResults);
+    }
+    double refNs = perOp(start, Iterations);
+
+    start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            QuatResults[i] = Quats[i] * Quats[(i + k) & (OperandCount - 1)];
+        endPass(QuatResults);
+    }
+    report("Quatf::operator*", refNs, perOp(start, Iterations), badMul ? "MISMATCH" : "exact");
+
+    start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            VectorResults[i] = Reference::Rotate(Quats[(i + k) & (OperandCount - 1)], Vectors[i]);
+        endPass(VectorResults);
+    }
+    refNs = perOp(start, Iterations);
+
+    start = Timer::GetProfileSeconds();
+    for (int k = 0; k < Iterations; k++)
+    {
+        for (int i = 0; i < OperandCount; i++)
+            VectorResults[i] = Quats[(i + k) & (OperandCount - 1)].Rotate(Vectors[i]);
+        endPass(VectorResults);
+    }
+    report("Quatf::Rotate", refNs, perOp(start, Iterations), badRotate ? "MISMATCH" : "exact");
+
+    Mismatches += badMul + badRotate;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        Iterations = Alg::Max(1, atoi(argv[1]));
+
+    System::Init();
+    initOperands();
+
+    printf("%d operands x %d passes, per operation:\n", (int)OperandCount, Iterations);
+    printf("    %-20s %9s  %9s\n", "", "generic", "current");
+    benchMultiply();
+    benchInverted();
+    benchQuats();
+
+#ifdef OVR_CPU_SSE
+    printf("SSE kernels enabled.\n");
+#else
+    printf("SSE kernels disabled; both columns run generic code.\n");
+#endif
+
+    System::Destroy();
+
+    if (Mismatches)
+    {
+        printf("%u results differ from the generic code\n", Mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -777,6 +777,33 @@ public:
 
 
 
+//-----------------------------------------------------------------------------------
+// ***** Memory barriers
+
+// ReadBarrier keeps loads before it from being reordered with loads after it, and
+// WriteBarrier does the same for stores, at both the compiler and the CPU level.
+// They are what a sequence lock needs around the data it protects; X86 keeps
+// loads and stores in order by itself, so there they only constrain the compiler.
+
+#if !defined(OVR_ENABLE_THREADS)
+inline void ReadBarrier()  { }
+inline void WriteBarrier() { }
+
+#elif defined(OVR_CC_MSVC)
+inline void ReadBarrier()  { _ReadWriteBarrier(); }
+inline void WriteBarrier() { _ReadWriteBarrier(); }
+
+#elif defined(OVR_CC_GNU) && (defined(OVR_CPU_X86) || defined(OVR_CPU_X86_64))
+inline void ReadBarrier()  { asm volatile("" ::: "memory"); }
+inline void WriteBarrier() { asm volatile("" ::: "memory"); }
+
+#elif defined(OVR_CC_GNU)
+inline void ReadBarrier()  { __sync_synchronize(); }
+inline void WriteBarrier() { __sync_synchronize(); }
+#endif
+
+
+
 //-----------------------------------------------------------------------------------
 // ***** Lock
 
@@ -62,6 +62,8 @@ const double Math<double>::SingularityRadius = 0.000000000001; // Use for Gimbal
 //-------------------------------------------------------------------------------------
 // ***** Matrix4f
 
+const Matrix4f Matrix4f::IdentityValue;
+
 
 Matrix4f Matrix4f::LookAtRH(const Vector3f& eye, const Vector3f& at, const Vector3f& up)
 {
@@ -24,6 +24,10 @@ otherwise accompanies this software in either electronic or hard copy form.
 #include "OVR_Types.h"
 #include "OVR_RefCount.h"
 
+#ifdef OVR_CPU_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace OVR {
 
 //-------------------------------------------------------------------------------------
@@ -330,7 +334,7 @@ typedef Vector3<double> Vector3d;
 
 class Matrix4f
 {
-    static Matrix4f IdentityValue;
+    static const Matrix4f IdentityValue;
 
 public:
     float M[4][4];    
@@ -341,6 +345,21 @@ public:
     Matrix4f(NoInitType) { }
 
     // By default, we construct identity matrix.
+    // With C++11 these constructors are constexpr, so constant matrices
+    // (IdentityValue, Translation of literals) need no code at startup.
+#ifdef OVR_CPP11
+    constexpr Matrix4f()
+        : M{ {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1} }
+    { }
+
+    constexpr Matrix4f(float m11, float m12, float m13, float m14,
+                       float m21, float m22, float m23, float m24,
+                       float m31, float m32, float m33, float m34,
+                       float m41, float m42, float m43, float m44)
+        : M{ {m11, m12, m13, m14}, {m21, m22, m23, m24},
+             {m31, m32, m33, m34}, {m41, m42, m43, m44} }
+    { }
+#else
     Matrix4f()
     {
         SetIdentity();        
@@ -356,6 +375,7 @@ public:
         M[2][0] = m31; M[2][1] = m32; M[2][2] = m33; M[2][3] = m34;
         M[3][0] = m41; M[3][1] = m42; M[3][2] = m43; M[3][3] = m44;
     }
+#endif
 
     Matrix4f(float m11, float m12, float m13,
              float m21, float m22, float m23,
@@ -378,9 +398,21 @@ public:
     }
 
     // Multiplies two matrices into destination with minimum copying.
+    // The SSE path forms each row as a[i][0]*b[0] + ... + a[i][3]*b[3], adding
+    // in the same order as the scalar code, so both give identical results.
     static Matrix4f& Multiply(Matrix4f* d, const Matrix4f& a, const Matrix4f& b)
     {
         OVR_ASSERT((d != &a) && (d != &b));
+#ifdef OVR_CPU_SSE
+        // Unaligned loads: Matrix4f is embedded in structures that don't align it
+        __m128 b0 = _mm_loadu_ps(b.M[0]), b1 = _mm_loadu_ps(b.M[1]),
+               b2 = _mm_loadu_ps(b.M[2]), b3 = _mm_loadu_ps(b.M[3]);
+
+        _mm_storeu_ps(d->M[0], multiplyRow(a.M[0], b0, b1, b2, b3));
+        _mm_storeu_ps(d->M[1], multiplyRow(a.M[1], b0, b1, b2, b3));
+        _mm_storeu_ps(d->M[2], multiplyRow(a.M[2], b0, b1, b2, b3));
+        _mm_storeu_ps(d->M[3], multiplyRow(a.M[3], b0, b1, b2, b3));
+#else
         int i = 0;
         do {
             d->M[i][0] = a.M[i][0] * b.M[0][0] + a.M[i][1] * b.M[1][0] + a.M[i][2] * b.M[2][0] + a.M[i][3] * b.M[3][0];
@@ -388,6 +420,7 @@ public:
             d->M[i][2] = a.M[i][0] * b.M[0][2] + a.M[i][1] * b.M[1][2] + a.M[i][2] * b.M[2][2] + a.M[i][3] * b.M[3][2];
             d->M[i][3] = a.M[i][0] * b.M[0][3] + a.M[i][1] * b.M[1][3] + a.M[i][2] * b.M[2][3] + a.M[i][3] * b.M[3][3];
         } while((++i) < 4);
+#endif
 
         return *d;
     }
@@ -468,11 +501,42 @@ public:
                         Cofactor(0,3), Cofactor(1,3), Cofactor(2,3), Cofactor(3,3));
     }
 
+    // Inverse from the 2x2 sub-determinants of the top and bottom row pairs,
+    // which share the work that computing each Cofactor separately repeats.
     Matrix4f Inverted() const
     {
-        float det = Determinant();
+        float a00 = M[0][0], a01 = M[0][1], a02 = M[0][2], a03 = M[0][3],
+              a10 = M[1][0], a11 = M[1][1], a12 = M[1][2], a13 = M[1][3],
+              a20 = M[2][0], a21 = M[2][1], a22 = M[2][2], a23 = M[2][3],
+              a30 = M[3][0], a31 = M[3][1], a32 = M[3][2], a33 = M[3][3];
+
+        float b00 = a00 * a11 - a01 * a10, b01 = a00 * a12 - a02 * a10,
+              b02 = a00 * a13 - a03 * a10, b03 = a01 * a12 - a02 * a11,
+              b04 = a01 * a13 - a03 * a11, b05 = a02 * a13 - a03 * a12,
+              b06 = a20 * a31 - a21 * a30, b07 = a20 * a32 - a22 * a30,
+              b08 = a20 * a33 - a23 * a30, b09 = a21 * a32 - a22 * a31,
+              b10 = a21 * a33 - a23 * a31, b11 = a22 * a33 - a23 * a32;
+
+        float det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
         assert(det != 0);
-        return Adjugated() * (1.0f/det);
+        float s = 1.0f / det;
+
+        return Matrix4f(( a11 * b11 - a12 * b10 + a13 * b09) * s,
+                        (-a01 * b11 + a02 * b10 - a03 * b09) * s,
+                        ( a31 * b05 - a32 * b04 + a33 * b03) * s,
+                        (-a21 * b05 + a22 * b04 - a23 * b03) * s,
+                        (-a10 * b11 + a12 * b08 - a13 * b07) * s,
+                        ( a00 * b11 - a02 * b08 + a03 * b07) * s,
+                        (-a30 * b05 + a32 * b02 - a33 * b01) * s,
+                        ( a20 * b05 - a22 * b02 + a23 * b01) * s,
+                        ( a10 * b10 - a11 * b08 + a13 * b06) * s,
+                        (-a00 * b10 + a01 * b08 - a03 * b06) * s,
+                        ( a30 * b04 - a31 * b02 + a33 * b00) * s,
+                        (-a20 * b04 + a21 * b02 - a23 * b00) * s,
+                        (-a10 * b09 + a11 * b07 - a12 * b06) * s,
+                        ( a00 * b09 - a01 * b07 + a02 * b06) * s,
+                        (-a30 * b03 + a31 * b01 - a32 * b00) * s,
+                        ( a20 * b03 - a21 * b01 + a22 * b00) * s);
     }
 
     void Invert()
@@ -587,20 +651,15 @@ public:
 
     static Matrix4f Translation(const Vector3f& v)
     {
-        Matrix4f t;
-        t.M[0][3] = v.x;
-        t.M[1][3] = v.y;
-        t.M[2][3] = v.z;
-        return t;
+        return Translation(v.x, v.y, v.z);
     }
 
-    static Matrix4f Translation(float x, float y, float z = 0.0f)
+    static OVR_CONSTEXPR Matrix4f Translation(float x, float y, float z = 0.0f)
     {
-        Matrix4f t;
-        t.M[0][3] = x;
-        t.M[1][3] = y;
-        t.M[2][3] = z;
-        return t;
+        return Matrix4f(1, 0, 0, x,
+                        0, 1, 0, y,
+                        0, 0, 1, z,
+                        0, 0, 0, 1);
     }
 
     static Matrix4f Scaling(const Vector3f& v)
@@ -740,6 +799,17 @@ public:
 
 
     static Matrix4f Ortho2D(float w, float h);
+
+private:
+#ifdef OVR_CPU_SSE
+    // a[0]*b0 + a[1]*b1 + a[2]*b2 + a[3]*b3, summed left to right
+    static __m128 multiplyRow(const float a[4], __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                   _mm_mul_ps(_mm_set1_ps(a[0]), b0), _mm_mul_ps(_mm_set1_ps(a[1]), b1)),
+                   _mm_mul_ps(_mm_set1_ps(a[2]), b2)), _mm_mul_ps(_mm_set1_ps(a[3]), b3));
+    }
+#endif
 };
 
 
@@ -759,8 +829,8 @@ public:
     // w + Xi + Yj + Zk
     T x, y, z, w;    
 
-    Quat() : x(0), y(0), z(0), w(1) {}
-    Quat(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
+    OVR_CONSTEXPR Quat() : x(0), y(0), z(0), w(1) {}
+    OVR_CONSTEXPR Quat(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
 
 
     // Constructs rotation quaternion around the axis.
@@ -1016,6 +1086,43 @@ public:
 };
 
 
+#ifdef OVR_CPU_SSE
+// Quatf products as 4-wide expressions: a*b = aw*b + ax*(bw,-bz,by,-bx)
+// + ay*(bz,bw,-bx,-by) + az*(-by,bx,bw,-bz).  The terms and their order
+// match the generic version, so the results are identical.
+inline __m128 QuatfMultiplySSE(__m128 a, __m128 b)
+{
+    __m128 s1 = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0,1,2,3)), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f));
+    __m128 s2 = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1,0,3,2)), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f));
+    __m128 s3 = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2,3,0,1)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
+    return _mm_add_ps(_mm_add_ps(_mm_add_ps(
+               _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,3,3)), b),
+               _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0,0,0,0)), s1)),
+               _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1,1,1,1)), s2)),
+               _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2,2,2,2)), s3));
+}
+
+template<>
+inline Quat<float> Quat<float>::operator* (const Quat<float>& b) const
+{
+    Quat<float> result;
+    _mm_storeu_ps(&result.x, QuatfMultiplySSE(_mm_loadu_ps(&x), _mm_loadu_ps(&b.x)));
+    return result;
+}
+
+// Both products stay in registers.
+template<>
+inline Vector3<float> Quat<float>::Rotate(const Vector3<float>& v) const
+{
+    __m128 q = _mm_loadu_ps(&x);
+    __m128 r = QuatfMultiplySSE(QuatfMultiplySSE(q, _mm_setr_ps(v.x, v.y, v.z, 0.0f)),
+                                _mm_xor_ps(q, _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f)));
+    float out[4];
+    _mm_storeu_ps(out, r);
+    return Vector3<float>(out[0], out[1], out[2]);
+}
+#endif
+
 typedef Quat<float>  Quatf;
 typedef Quat<double> Quatd;
 
@@ -780,7 +780,12 @@ bool    Thread::MSleep(unsigned msecs)
 /* static */
 int     Thread::GetCPUCount()
 {
+#if defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#else
     return 1;
+#endif
 }
 
 
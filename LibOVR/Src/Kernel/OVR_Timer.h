@@ -69,6 +69,13 @@ public:
     // Due to low precision of Double, may malfunction after long runtime.
     static double  OVR_STDCALL GetProfileSeconds();
 
+    // Absolute hi-res time in seconds, on the GetProfileTicks clock. Sensor messages
+    // are timestamped with it, so it is the clock to use for prediction targets.
+    static inline double GetSeconds()
+    {
+        return TicksToSeconds(GetProfileTicks());
+    }
+
     // Get the raw cycle counter value, providing the maximum possible timer resolution.
     static UInt64  OVR_STDCALL GetRawTicks();
     static UInt64  OVR_STDCALL GetRawFrequency();
@@ -274,6 +274,7 @@ namespace BaseTypes
 //
 //  OVR_BYTE_ORDER      - Defined to either OVR_LITTLE_ENDIAN or OVR_BIG_ENDIAN
 //  OVR_FORCE_INLINE    - Forces inline expansion of function
+//  OVR_CONSTEXPR       - constexpr when the compiler supports C++11, else nothing
 //  OVR_ASM             - Assembly language prefix
 //  OVR_STR             - Prefixes string with L"" if building unicode
 // 
@@ -297,6 +298,15 @@ namespace BaseTypes
 #endif  // OVR_CC_MSVC
 
 
+// OVR_CPP11 is defined when compiling as C++11 or later (MSVC 2015+ supports constexpr).
+#if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#  define OVR_CPP11
+#  define OVR_CONSTEXPR     constexpr
+#else
+#  define OVR_CONSTEXPR
+#endif
+
+
 #if defined(OVR_OS_WIN32)
     
     // ***** Win32
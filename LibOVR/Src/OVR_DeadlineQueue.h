@@ -0,0 +1,194 @@
+/************************************************************************************
+
+Filename    :   OVR_DeadlineQueue.h
+Content     :   Min-heap of items ordered by absolute deadline.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#ifndef OVR_DeadlineQueue_h
+#define OVR_DeadlineQueue_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+
+namespace OVR {
+
+//-------------------------------------------------------------------------------------
+// ***** DeadlineQueue
+
+// DeadlineQueue keeps items ordered by an absolute deadline (Timer::GetTicks()
+// microseconds) in a binary min-heap. DeviceManagerThread uses it to find the next
+// tick notifier due: looking at the earliest deadline is O(1) and rescheduling it
+// is O(log n), so notifiers that are not due are never visited. RunDue does the
+// whole pass for a thread loop.
+// Schedule and Remove of an arbitrary item search linearly; they are rare and the
+// queue holds one entry per open device.
+// Not thread safe; owned by a single thread.
+
+template<class T>
+class DeadlineQueue
+{
+public:
+
+    bool    IsEmpty() const             { return Heap.GetSize() == 0; }
+    UPInt   GetSize() const             { return Heap.GetSize(); }
+
+    // Earliest item and its deadline. Queue must not be empty.
+    T       GetTop() const              { return Heap[0].Item; }
+    UInt64  GetTopDeadline() const      { return Heap[0].Deadline; }
+
+    // Queues item at deadline, or moves it there if it is already queued.
+    void    Schedule(T item, UInt64 deadline)
+    {
+        UPInt index = find(item);
+        if (index == Heap.GetSize())
+        {
+            Heap.PushBack(Entry(item, deadline));
+            siftUp(index);
+        }
+        else
+        {
+            update(index, deadline);
+        }
+    }
+
+    // Moves the earliest item to a new deadline.
+    void    RescheduleTop(UInt64 deadline)
+    {
+        OVR_ASSERT(!IsEmpty());
+        update(0, deadline);
+    }
+
+    bool    Remove(T item)
+    {
+        UPInt index = find(item);
+        if (index == Heap.GetSize())
+            return false;
+
+        UPInt last = Heap.GetSize() - 1;
+        if (index != last)
+        {
+            Entry moved = Heap[last];
+            Heap.PopBack();
+            Heap[index].Item = moved.Item;
+            update(index, moved.Deadline);
+        }
+        else
+        {
+            Heap.PopBack();
+        }
+        return true;
+    }
+
+    bool    Contains(T item) const      { return find(item) != Heap.GetSize(); }
+
+    // Calls (item->*onDue)(nowMks) for the items due at nowMks, earliest first, and
+    // reschedules each by the delay it returns. A delay of 0 counts as 1, so that
+    // the item is not due again until the next call and every due item gets its
+    // turn. An item may Schedule or Remove items while it runs; the pass makes at
+    // most as many calls as there were items, so rescheduling one to nowMks or
+    // earlier can't keep it going either.
+    // Returns the delay until the next deadline, or ~0 if the queue is empty.
+    template<class C>
+    UInt64  RunDue(UInt64 nowMks, UInt64 (C::*onDue)(UInt64))
+    {
+        for (UPInt count = GetSize();
+             count > 0 && !IsEmpty() && GetTopDeadline() <= nowMks;
+             count--)
+        {
+            T      item  = GetTop();
+            UInt64 delay = (item->*onDue)(nowMks);
+
+            // The item may have removed or rescheduled itself.
+            if (!IsEmpty() && GetTop() == item)
+            {
+                UInt64 deadline = nowMks + ((delay > 0) ? delay : 1);
+                RescheduleTop((deadline < nowMks) ? ~UInt64(0) : deadline);
+            }
+        }
+
+        if (IsEmpty())
+            return ~UInt64(0);
+
+        UInt64 deadline = GetTopDeadline();
+        return (deadline > nowMks) ? (deadline - nowMks) : 0;
+    }
+
+private:
+
+    struct Entry
+    {
+        UInt64  Deadline;
+        T       Item;
+
+        Entry() : Deadline(0), Item() { }
+        Entry(T item, UInt64 deadline) : Deadline(deadline), Item(item) { }
+    };
+
+    UPInt   find(T item) const
+    {
+        UPInt i;
+        for (i = 0; i < Heap.GetSize(); i++)
+        {
+            if (Heap[i].Item == item)
+                break;
+        }
+        return i;
+    }
+
+    void    update(UPInt index, UInt64 deadline)
+    {
+        UInt64 old = Heap[index].Deadline;
+        Heap[index].Deadline = deadline;
+        if (deadline < old)
+            siftUp(index);
+        else
+            siftDown(index);
+    }
+
+    void    siftUp(UPInt index)
+    {
+        Entry e = Heap[index];
+        while (index > 0)
+        {
+            UPInt parent = (index - 1) / 2;
+            if (Heap[parent].Deadline <= e.Deadline)
+                break;
+            Heap[index] = Heap[parent];
+            index       = parent;
+        }
+        Heap[index] = e;
+    }
+
+    void    siftDown(UPInt index)
+    {
+        Entry e    = Heap[index];
+        UPInt size = Heap.GetSize();
+        for (;;)
+        {
+            UPInt child = index * 2 + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && Heap[child + 1].Deadline < Heap[child].Deadline)
+                child++;
+            if (e.Deadline <= Heap[child].Deadline)
+                break;
+            Heap[index] = Heap[child];
+            index       = child;
+        }
+        Heap[index] = e;
+    }
+
+    ArrayPOD<Entry> Heap;
+};
+
+} // namespace OVR
+
+#endif // OVR_DeadlineQueue_h
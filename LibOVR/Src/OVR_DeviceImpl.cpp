@@ -31,6 +31,7 @@ namespace OVR {
 // moved to Kernel.
 // May in theory busy spin-wait if we hit contention on first lock creation,
 // but this shouldn't matter in practice since Lock* should be cached.
+// All LockCount locks live as long as any of them is in use.
 
 
 enum { LockInitMarker = 0xFFFFFFFF };
@@ -49,23 +50,25 @@ Lock* SharedLock::GetLockAddRef()
             // Initialize marker
             if (AtomicOps<int>::CompareAndSet_Sync(&UseCount, 0, LockInitMarker))
             {
-                Construct<Lock>(Buffer);
+                for (int i = 0; i < LockCount; i++)
+                    Construct<Lock>(toLock(i));
                 do { }
                 while (!AtomicOps<int>::CompareAndSet_Sync(&UseCount, LockInitMarker, 1));
-                return toLock();
+                break;
             }
             continue;
         }
 
     } while (!AtomicOps<int>::CompareAndSet_NoSync(&UseCount, oldUseCount, oldUseCount + 1));
 
-    return toLock();
+    UInt32 index = (UInt32)AtomicOps<int>::ExchangeAdd_NoSync(&NextLock, 1);
+    return toLock(index % LockCount);
 }
 
 void SharedLock::ReleaseLock(Lock* plock)
 {
     OVR_UNUSED(plock);
-    OVR_ASSERT((plock = toLock()) != 0);
+    OVR_ASSERT(plock >= toLock(0) && plock < toLock(LockCount));
 
     int oldUseCount;
 
@@ -78,7 +81,8 @@ void SharedLock::ReleaseLock(Lock* plock)
             // Initialize marker
             if (AtomicOps<int>::CompareAndSet_Sync(&UseCount, 1, LockInitMarker))
             {
-                Destruct<Lock>(toLock());
+                for (int i = 0; i < LockCount; i++)
+                    Destruct<Lock>(toLock(i));
 
                 do { }
                 while (!AtomicOps<int>::CompareAndSet_Sync(&UseCount, LockInitMarker, 0));
@@ -100,6 +104,8 @@ void SharedLock::ReleaseLock(Lock* plock)
 // The OnMessage() handler and SetMessageHandler are currently synchronized
 // through a separately stored shared Lock object to avoid calling the handler 
 // from background thread while it's being removed.
+// Each handler gets its own Lock from the pool, so only devices delivering to
+// the same handler (or readers of its GetHandlerLock) contend.
 
 static SharedLock MessageHandlerSharedLock;
 
@@ -130,6 +136,8 @@ public:
 };
 
 
+// Until a handler is installed the ref uses a pool lock of its own; it only
+// guards pHandler then.
 MessageHandlerRef::MessageHandlerRef(DeviceBase* device)
     : pLock(MessageHandlerSharedLock.GetLockAddRef()), pDevice(device), pHandler(0)
 {
@@ -137,24 +145,61 @@ MessageHandlerRef::MessageHandlerRef(DeviceBase* device)
 
 MessageHandlerRef::~MessageHandlerRef()
 {
+    Lock* plock = lockHandler();
+    if (pHandler)
     {
-        Lock::Locker lockScope(pLock);
-        if (pHandler)
-        {
-            pHandler = 0;
-            RemoveNode();
-        }
+        pHandler = 0;
+        RemoveNode();
     }
-    MessageHandlerSharedLock.ReleaseLock(pLock);
+    plock->Unlock();
+
+    MessageHandlerSharedLock.ReleaseLock(plock);
     pLock = 0;
 }
 
+Lock* MessageHandlerRef::lockHandler() const
+{
+    while (true)
+    {
+        Lock* plock = pLock;
+        plock->DoLock();
+        // pLock is only replaced with both locks held, so it can't change now.
+        if (plock == pLock)
+            return plock;
+        plock->Unlock();
+    }
+}
+
 void MessageHandlerRef::SetHandler(MessageHandler* handler)
 {    
-    OVR_ASSERT(!handler ||
-               MessageHandlerImpl::FromHandler(handler)->pLock == pLock);    
-    Lock::Locker lockScope(pLock);
+    Lock* newLock = handler ? MessageHandlerImpl::FromHandler(handler)->pLock : 0;
+    Lock* oldLock;
+
+    // Take the current and new handler locks in address order, so two threads
+    // swapping handlers between the same pair of locks can't deadlock.
+    while (true)
+    {
+        oldLock = pLock;
+        Lock* first  = (newLock && newLock < oldLock) ? newLock : oldLock;
+        Lock* second = (first == oldLock) ? newLock : oldLock;
+
+        first->DoLock();
+        if (second && second != first)
+            second->DoLock();
+        if (oldLock == pLock)
+            break;
+        if (second && second != first)
+            second->Unlock();
+        first->Unlock();
+    }
+
     SetHandler_NTS(handler);
+    if (newLock)
+        pLock = newLock;
+
+    if (newLock && newLock != oldLock)
+        newLock->Unlock();
+    oldLock->Unlock();
 }
 
 void MessageHandlerRef::SetHandler_NTS(MessageHandler* handler)
@@ -289,8 +334,9 @@ public:
 // ***** DeviceManagerImpl
 
 DeviceManagerImpl::DeviceManagerImpl()
-    : DeviceImpl<OVR::DeviceManager>(CreateManagerDesc(), 0)
-      //,DeviceCreateDescList(pCreateDesc ? pCreateDesc->pLock : 0)
+    : DeviceImpl<OVR::DeviceManager>(CreateManagerDesc(), 0),
+      //DeviceCreateDescList(pCreateDesc ? pCreateDesc->pLock : 0),
+      Enumerating(false)
 {
     if (pCreateDesc)
     {
@@ -438,23 +484,31 @@ Void DeviceManagerImpl::ReleaseDevice_MgrThread(DeviceBase* device)
 
 Void DeviceManagerImpl::EnumerateAllFactoryDevices()
 {
-    // 1. Mark matching devices as NOT enumerated.
+    // 1. Mark matching devices as NOT enumerated, remembering which were.
     // 2. Call factory to enumerate all HW devices, adding any device that 
     //    was not matched.
     // 3. Remove non-matching devices.
+    //
+    // Descriptors are kept across passes and only cloned for devices not seen
+    // before, and listeners only hear about devices that came or went, so
+    // re-enumerating an unchanged set of devices doesn't allocate or notify.
 
     Lock::Locker deviceLock(GetLock());
 
     DeviceCreateDesc* devDesc, *nextdevDesc;
+    bool              wasEnumerating = Enumerating;
 
     // 1.
     for(devDesc = Devices.GetFirst();
         !Devices.IsNull(devDesc);  devDesc = devDesc->pNext)
     {
         //if (devDesc->pFactory == factory)
-            devDesc->Enumerated = false;
+        devDesc->WasEnumerated = devDesc->Enumerated;
+        devDesc->Enumerated    = false;
     }
     
+    Enumerating = true;
+    
     // 2.
     DeviceFactory* factory = Factories.GetFirst();
     while(!Factories.IsNull(factory))
@@ -463,6 +517,7 @@ Void DeviceManagerImpl::EnumerateAllFactoryDevices()
         factory = factory->pNext;
     }
 
+    Enumerating = wasEnumerating;
     
     // 3.
     for(devDesc = Devices.GetFirst();
@@ -473,7 +528,9 @@ Void DeviceManagerImpl::EnumerateAllFactoryDevices()
 
         // Note, device might be not enumerated since it is opened and
         // in use! Do NOT notify 'device removed' in this case (!AB)
-        if (!devDesc->Enumerated)
+        // Descriptors kept alive by handles after their device went away
+        // were reported by an earlier pass.
+        if (!devDesc->Enumerated && devDesc->WasEnumerated)
         {
             // This deletes the devDesc for HandleCount == 0 due to Release in DeviceHandle.
             CallOnDeviceRemoved(devDesc);
@@ -496,7 +553,8 @@ Void DeviceManagerImpl::EnumerateAllFactoryDevices()
 Ptr<DeviceCreateDesc> DeviceManagerImpl::AddDevice_NeedsLock(
     const DeviceCreateDesc& createDesc)
 {
-    // If found, mark as enumerated and we are done.
+    // If found, mark as enumerated and we are done. An enumeration pass
+    // only reports a device that the previous pass didn't list.
     DeviceCreateDesc* descCandidate = 0;
 
     for(DeviceCreateDesc* devDesc = Devices.GetFirst();
@@ -505,8 +563,10 @@ Ptr<DeviceCreateDesc> DeviceManagerImpl::AddDevice_NeedsLock(
         DeviceCreateDesc::MatchResult mr = devDesc->MatchDevice(createDesc, &descCandidate);
         if (mr == DeviceCreateDesc::Match_Found)
         {
+            bool added = !devDesc->pDevice &&
+                         (!Enumerating || (!devDesc->Enumerated && !devDesc->WasEnumerated));
             devDesc->Enumerated = true;
-            if (!devDesc->pDevice)
+            if (added)
                 CallOnDeviceAdded(devDesc);
             return devDesc;
         }
@@ -518,8 +578,10 @@ Ptr<DeviceCreateDesc> DeviceManagerImpl::AddDevice_NeedsLock(
         bool newDevice = false;
         if (descCandidate->UpdateMatchedCandidate(createDesc, &newDevice))
         {
+            bool added = newDevice || (!descCandidate->pDevice &&
+                         (!Enumerating || (!descCandidate->Enumerated && !descCandidate->WasEnumerated)));
             descCandidate->Enumerated = true;
-            if (!descCandidate->pDevice || newDevice)
+            if (added)
                 CallOnDeviceAdded(descCandidate);
             return descCandidate;
         }
@@ -36,27 +36,39 @@ enum
 };
 
 //-------------------------------------------------------------------------------------
-// Globally shared Lock implementation used for MessageHandlers.
+// Globally shared pool of Locks used for MessageHandlers. GetLockAddRef hands the
+// locks out round-robin, so up to LockCount handlers never share one. The pool
+// does not grow: with more live handlers than that, handler N + LockCount gets
+// handler N's lock, and the two block each other in OnMessage and GetHandlerLock.
 
 class SharedLock
 {    
 public:
+    enum { LockCount = 32 };
 
     Lock* GetLockAddRef();
     void  ReleaseLock(Lock* plock);
    
 private:
-    Lock* toLock() { return (Lock*)Buffer; }
+    enum { LockSize = (sizeof(Lock)+sizeof(UInt64)-1)/sizeof(UInt64) };
+
+    Lock* toLock(int i) { return (Lock*)(Buffer + i * LockSize); }
 
     // UseCount and max alignment.
     volatile int    UseCount;
-    UInt64          Buffer[(sizeof(Lock)+sizeof(UInt64)-1)/sizeof(UInt64)];
+    volatile int    NextLock;
+    UInt64          Buffer[LockCount * LockSize];
 };
 
 
 // Wrapper for MessageHandler that includes synchronization logic.
 // References to MessageHandlers are organized in a list to allow for them to
 // easily removed with MessageHandler::RemoveAllHandlers.
+//
+// Messages are delivered under the lock of the installed handler, so devices
+// with different handlers don't serialize on each other. pLock is that lock,
+// or the last one if the handler was removed; it only changes while both the
+// old and the new lock are held.
 class MessageHandlerRef : public ListNode<MessageHandlerRef>
 {    
 public:
@@ -68,9 +80,19 @@ public:
     // Not-thread-safe version
     void SetHandler_NTS(MessageHandler* hander);
     
+    // Holds the handler lock; the handler can't be changed or removed in scope.
+    // Use this rather than locking GetLock(), which may be replaced meanwhile.
+    class Locker
+    {
+    public:
+        Lock *pLock;
+        inline Locker(const MessageHandlerRef& ref) : pLock(ref.lockHandler()) { }
+        inline ~Locker() { pLock->Unlock(); }
+    };
+
     void Call(const Message& msg)
     {
-        Lock::Locker lockScope(pLock);
+        Locker lockScope(*this);
         if (pHandler)
             pHandler->OnMessage(msg);
     }
@@ -83,7 +105,10 @@ public:
     DeviceBase*     GetDevice() const  { return pDevice; }
 
 private:
-    Lock*           pLock;   // Cached global handler lock.
+    // Locks pLock, retrying if it was replaced before we got it.
+    Lock*           lockHandler() const;
+
+    Lock* volatile  pLock;   // Cached handler lock.
     DeviceBase*     pDevice;
     MessageHandler* pHandler;
 };
@@ -120,7 +145,8 @@ class DeviceCreateDesc : public ListNode<DeviceCreateDesc>, public NewOverrideBa
     void operator = (const DeviceCreateDesc&) { } // Assign not supported; suppress MSVC warning.
 public:
     DeviceCreateDesc(DeviceFactory* factory, DeviceType type)
-        : pFactory(factory), Type(type), pLock(0), HandleCount(0), pDevice(0), Enumerated(true)
+        : pFactory(factory), Type(type), pLock(0), HandleCount(0), pDevice(0),
+          Enumerated(true), WasEnumerated(false)
     {
         pNext = pPrev = 0;
     }
@@ -197,6 +223,9 @@ public:
     DeviceBase*                 pDevice;
     // True if device is marked as available during enumeration.
     bool                        Enumerated;
+    // Enumerated as of the start of the current enumeration pass; lets the pass
+    // report only the devices that came or went since the previous one.
+    bool                        WasEnumerated;
 };
 
 
@@ -415,6 +444,10 @@ public:
     // Factories used to detect and manage devices.
     List<DeviceFactory>     Factories;
 
+    // True while EnumerateAllFactoryDevices runs. Descriptors found again in such
+    // a pass are matched silently; hot-plug detection always reports its device.
+    bool                    Enumerating;
+
 protected:
     Ptr<HIDDeviceManager>   HidDeviceManager;
 };
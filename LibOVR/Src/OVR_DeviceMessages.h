@@ -44,6 +44,7 @@ enum MessageType
     Message_DeviceRemoved           = OVR_MESSAGETYPE(Manager, 1),  // Existing device has been plugged/unplugged.
     // Sensor Messages
     Message_BodyFrame               = OVR_MESSAGETYPE(Sensor, 0),   // Emitted by sensor at regular intervals.
+    Message_BodyFrameBatch          = OVR_MESSAGETYPE(Sensor, 1),   // All BodyFrames of one sensor report.
     // Latency Tester Messages
     Message_LatencyTestSamples          = OVR_MESSAGETYPE(LatencyTester, 0),
     Message_LatencyTestColorDetected    = OVR_MESSAGETYPE(LatencyTester, 1),
@@ -81,8 +82,9 @@ public:
 class MessageBodyFrame : public Message
 {
 public:
-    MessageBodyFrame(DeviceBase* dev)
-        : Message(Message_BodyFrame, dev), Temperature(0.0f), TimeDelta(0.0f)
+    MessageBodyFrame(DeviceBase* dev = 0)
+        : Message(Message_BodyFrame, dev), Temperature(0.0f), TimeDelta(0.0f),
+          AbsoluteTimeSeconds(0.0)
     {
     }
 
@@ -91,6 +93,32 @@ public:
     Vector3f MagneticField;  // Magnetic field strength in Gauss.
     float    Temperature;    // Temperature reading on sensor surface, in degrees Celsius.
     float    TimeDelta;      // Time passed since last Body Frame, in seconds.
+    double   AbsoluteTimeSeconds; // When the sample was taken, on the Timer::GetSeconds()
+                                  // clock; 0 if unknown.
+};
+
+// Sensor BodyFrameBatch notification: the BodyFrames decoded from one sensor report,
+// oldest first, delivered with a single OnMessage call. It is sent in addition to the
+// individual BodyFrames; a handler that only wants the batch should return 'false'
+// from SupportsMessageType(Message_BodyFrame), and one that only wants single frames
+// 'false' for Message_BodyFrameBatch.
+// The batch belongs to the device and is reused for every report, so handlers must
+// copy anything they keep past OnMessage.
+class MessageBodyFrameBatch : public Message
+{
+public:
+    // Up to three samples per report, plus one filling in for missed reports.
+    enum { MaxFrames = 4 };
+
+    MessageBodyFrameBatch(DeviceBase* dev = 0)
+        : Message(Message_BodyFrameBatch, dev), FrameCount(0)
+    {
+        for (unsigned i = 0; i < MaxFrames; i++)
+            Frames[i].pDevice = dev;
+    }
+
+    MessageBodyFrame Frames[MaxFrames];
+    unsigned         FrameCount;
 };
 
 // Sent when we receive a device status changes (e.g.:
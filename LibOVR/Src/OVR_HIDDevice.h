@@ -131,10 +131,18 @@ public:
         { OVR_UNUSED1(messageType); }
     };
 
-    void SetHandler(HIDHandler* handler)
-    { Handler = handler; }
+    virtual void SetHandler(HIDHandler* handler)
+    {
+        Handler = handler;
+        // The old handler's deadline means nothing to the new one.
+        RestartTicks();
+    }
 
 protected:
+    // Implementations that call OnTicks make the next call come right away,
+    // so that a new handler is asked for its first deadline.
+    virtual void RestartTicks() { }
+
     HIDHandler* Handler;
 };
 
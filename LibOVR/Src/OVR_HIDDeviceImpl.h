@@ -67,7 +67,7 @@ public:
 
         // Do device notification.
         {
-            Lock::Locker scopeLock(this->HandlerRef.GetLock());
+            MessageHandlerRef::Locker scopeLock(this->HandlerRef);
 
             if (this->HandlerRef.GetHandler())
             {
@@ -723,7 +723,7 @@ void LatencyTestDeviceImpl::onLatencyTestSamplesMessage(LatencyTestSamplesMessag
     LatencyTestSamples& s = message->Samples;
 
     // Call OnMessage() within a lock to avoid conflicts with handlers.
-    Lock::Locker scopeLock(HandlerRef.GetLock());
+    MessageHandlerRef::Locker scopeLock(HandlerRef);
   
     if (HandlerRef.GetHandler())
     {
@@ -745,7 +745,7 @@ void LatencyTestDeviceImpl::onLatencyTestColorDetectedMessage(LatencyTestColorDe
     LatencyTestColorDetected& s = message->ColorDetected;
 
     // Call OnMessage() within a lock to avoid conflicts with handlers.
-    Lock::Locker scopeLock(HandlerRef.GetLock());
+    MessageHandlerRef::Locker scopeLock(HandlerRef);
 
     if (HandlerRef.GetHandler())
     {
@@ -766,7 +766,7 @@ void LatencyTestDeviceImpl::onLatencyTestStartedMessage(LatencyTestStartedMessag
     LatencyTestStarted& ts = message->TestStarted;
 
     // Call OnMessage() within a lock to avoid conflicts with handlers.
-    Lock::Locker scopeLock(HandlerRef.GetLock());
+    MessageHandlerRef::Locker scopeLock(HandlerRef);
 
     if (HandlerRef.GetHandler())
     {
@@ -785,7 +785,7 @@ void LatencyTestDeviceImpl::onLatencyTestButtonMessage(LatencyTestButtonMessage*
 //  LatencyTestButton& s = message->Button;
 
     // Call OnMessage() within a lock to avoid conflicts with handlers.
-    Lock::Locker scopeLock(HandlerRef.GetLock());
+    MessageHandlerRef::Locker scopeLock(HandlerRef);
 
     if (HandlerRef.GetHandler())
     {
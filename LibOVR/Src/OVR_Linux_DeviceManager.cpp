@@ -0,0 +1,420 @@
+/************************************************************************************
+
+Filename    :   OVR_Linux_DeviceManager.cpp
+Content     :   Linux specific DeviceManager implementation.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_Linux_DeviceManager.h"
+
+// Sensor & HMD Factories
+#include "OVR_LatencyTestImpl.h"
+#include "OVR_SensorImpl.h"
+#include "OVR_Linux_HIDDevice.h"
+#include "OVR_Linux_HMDDevice.h"
+
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Log.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+
+namespace OVR { namespace Linux {
+
+//-------------------------------------------------------------------------------------
+// **** Linux::DeviceManager
+
+DeviceManager::DeviceManager()
+{
+    HidDeviceManager = *HIDDeviceManager::CreateInternal(this);
+}
+
+DeviceManager::~DeviceManager()
+{
+    // make sure Shutdown was called.
+    OVR_ASSERT(!pThread);
+}
+
+const char* DeviceManager::GetSysRoot()
+{
+    const char* root = getenv("OVR_HIDRAW_ROOT");
+    return root ? root : "";
+}
+
+int DeviceManager::ReadSysFile(const String& path, UByte* buffer, int bufferSize)
+{
+    int fd = ::open(path.ToCStr(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    int size = 0, bytesRead;
+    while (size < bufferSize &&
+           (bytesRead = (int)::read(fd, buffer + size, bufferSize - size)) > 0)
+    {
+        size += bytesRead;
+    }
+    ::close(fd);
+    return size;
+}
+
+bool DeviceManager::Initialize(DeviceBase*)
+{
+    if (!DeviceManagerImpl::Initialize(0))
+        return false;
+
+    pThread = *new DeviceManagerThread();
+    if (!pThread || !pThread->threadInitialized() || !pThread->Start())
+        return false;
+
+    // Hot-plug monitoring adds a descriptor to the thread, so it is done there.
+    if (HidDeviceManager)
+    {
+        pThread->PushCall(static_cast<HIDDeviceManager*>(HidDeviceManager.GetPtr()),
+                          &HIDDeviceManager::StartMonitoring, true);
+    }
+
+    pCreateDesc->pDevice = this;
+    LogText("OVR::DeviceManager - initialized.\n");
+    return true;
+}
+
+void DeviceManager::Shutdown()
+{
+    LogText("OVR::DeviceManager - shutting down.\n");
+
+    // Set Manager shutdown marker variable; this prevents
+    // any existing DeviceHandle objects from accessing device.
+    pCreateDesc->pLock->pManager = 0;
+
+    // The thread may outlive us, so it must stop calling into our HIDDeviceManager
+    // before that goes away with this object.
+    if (HidDeviceManager)
+    {
+        HIDDeviceManager* hidManager = static_cast<HIDDeviceManager*>(HidDeviceManager.GetPtr());
+        if (GetThreadId() != OVR::GetCurrentThreadId())
+            pThread->PushCall(hidManager, &HIDDeviceManager::StopMonitoring, true);
+        else
+            hidManager->StopMonitoring();
+    }
+
+    // Push for thread shutdown *WITH NO WAIT*.
+    // This will have the following effect:
+    //  - Exit command will get enqueued, which will be executed later on the thread itself.
+    //  - Beyond this point, this DeviceManager object may be deleted by our caller.
+    //  - Other commands, such as CreateDevice, may execute before ExitCommand, but they will
+    //    fail gracefully due to pLock->pManager == 0. Future commands can't be enqued
+    //    after pManager is null.
+    //  - Once ExitCommand executes, ThreadCommand::Run loop will exit and release the last
+    //    reference to the thread object.
+    pThread->PushExitCommand(false);
+    pThread.Clear();
+
+    DeviceManagerImpl::Shutdown();
+}
+
+ThreadCommandQueue* DeviceManager::GetThreadQueue()
+{
+    return pThread;
+}
+
+ThreadId DeviceManager::GetThreadId() const
+{
+    return pThread->GetThreadId();
+}
+
+bool DeviceManager::GetDeviceInfo(DeviceInfo* info) const
+{
+    if ((info->InfoClassType != Device_Manager) &&
+        (info->InfoClassType != Device_None))
+        return false;
+
+    info->Type    = Device_Manager;
+    info->Version = 0;
+    OVR_strcpy(info->ProductName, DeviceInfo::MaxNameLength, "DeviceManager");
+    OVR_strcpy(info->Manufacturer,DeviceInfo::MaxNameLength, "Oculus VR, Inc.");
+    return true;
+}
+
+DeviceEnumerator<> DeviceManager::EnumerateDevicesEx(const DeviceEnumerationArgs& args)
+{
+    // TBD: Can this be avoided in the future, once proper device notification is in place?
+    if (GetThreadId() != OVR::GetCurrentThreadId())
+    {
+        pThread->PushCall((DeviceManagerImpl*)this,
+            &DeviceManager::EnumerateAllFactoryDevices, true);
+    }
+    else
+        DeviceManager::EnumerateAllFactoryDevices();
+
+    return DeviceManagerImpl::EnumerateDevicesEx(args);
+}
+
+bool DeviceManager::GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const
+{
+    if (GetHIDDeviceManager())
+        return static_cast<HIDDeviceManager*>(GetHIDDeviceManager())->GetHIDDeviceDesc(path, pdevDesc);
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** DeviceManager Thread
+
+DeviceManagerThread::DeviceManagerThread()
+    : Thread(ThreadStackSize), EpollFd(-1), CommandFd(-1)
+{
+    EpollFd   = epoll_create1(EPOLL_CLOEXEC);
+    CommandFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (EpollFd < 0 || CommandFd < 0)
+    {
+        LogError("OVR::DeviceManagerThread - failed to create epoll/eventfd, errno = %d.\n", errno);
+        return;
+    }
+
+    // CommandFd isn't in SelectFds; Run recognizes it directly.
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = CommandFd;
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, CommandFd, &event);
+}
+
+DeviceManagerThread::~DeviceManagerThread()
+{
+    if (CommandFd >= 0)
+        close(CommandFd);
+    if (EpollFd >= 0)
+        close(EpollFd);
+}
+
+void DeviceManagerThread::OnPushNonEmpty_Locked()
+{
+    UInt64 one = 1;
+    // Can only fail if the counter is about to overflow, which is still signaled.
+    ssize_t written = write(CommandFd, &one, sizeof(one));
+    OVR_UNUSED(written);
+}
+
+void DeviceManagerThread::clearCommandEvent()
+{
+    UInt64 count;
+    ssize_t bytesRead = read(CommandFd, &count, sizeof(count));
+    OVR_UNUSED(bytesRead);
+}
+
+int DeviceManagerThread::Run()
+{
+    enum { MaxEvents = 16 };
+
+    ThreadCommand::PopBuffer command;
+
+    SetThreadName("OVR::DeviceManagerThread");
+    LogText("OVR::DeviceManagerThread - running (ThreadId=%p).\n", GetThreadId());
+
+    while(!IsExiting())
+    {
+        // PopCommand will reset event on empty queue.
+        if (PopCommand(&command))
+        {
+            command.Execute();
+        }
+        else
+        {
+            bool commandsPending = false;
+            while (!commandsPending)
+            {
+                int waitMs = -1;
+
+                // If devices have time-dependent logic registered, run the ones that
+                // are due and sleep until the next deadline. Rounding up keeps us from
+                // waking just short of it.
+                UInt64 waitMks = TicksNotifiers.RunDue(Timer::GetTicks(), &Notifier::OnTicks);
+                if (waitMks != ~UInt64(0))
+                {
+                    UInt64 waitAllowed = waitMks / Timer::MksPerMs + ((waitMks % Timer::MksPerMs) ? 1 : 0);
+                    waitMs = (waitAllowed > INT_MAX) ? INT_MAX : (int)waitAllowed;
+                }
+
+                epoll_event events[MaxEvents];
+                int count = epoll_wait(EpollFd, events, MaxEvents, waitMs);
+
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    LogError("OVR::DeviceManagerThread - epoll_wait failed, errno = %d.\n", errno);
+                    break;
+                }
+
+                for (int i = 0; i < count; i++)
+                {
+                    int fd = events[i].data.fd;
+
+                    if (fd == CommandFd)
+                    {
+                        clearCommandEvent();
+                        commandsPending = true;
+                        continue;
+                    }
+
+                    // Look the notifier up for every event, since handling an earlier
+                    // one may have removed it.
+                    for (UPInt j = 0; j < SelectFds.GetSize(); j++)
+                    {
+                        if (SelectFds[j] == fd)
+                        {
+                            SelectNotifiers[j]->OnEvent(fd);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    LogText("OVR::DeviceManagerThread - exiting (ThreadId=%p).\n", GetThreadId());
+    return 0;
+}
+
+bool DeviceManagerThread::AddSelectFd(Notifier* notify, int fd)
+{
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+
+    if (epoll_ctl(EpollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        return false;
+
+    SelectNotifiers.PushBack(notify);
+    SelectFds.PushBack(fd);
+    return true;
+}
+
+bool DeviceManagerThread::RemoveSelectFd(Notifier* notify, int fd)
+{
+    for (UPInt i = 0; i < SelectNotifiers.GetSize(); i++)
+    {
+        if ((SelectNotifiers[i] == notify) && (SelectFds[i] == fd))
+        {
+            epoll_ctl(EpollFd, EPOLL_CTL_DEL, fd, 0);
+            SelectNotifiers.RemoveAt(i);
+            SelectFds.RemoveAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeviceManagerThread::AddTicksNotifier(Notifier* notify)
+{
+    if (!TicksNotifiers.Contains(notify))
+        TicksNotifiers.Schedule(notify, 0);
+    return true;
+}
+
+bool DeviceManagerThread::RemoveTicksNotifier(Notifier* notify)
+{
+    return TicksNotifiers.Remove(notify);
+}
+
+bool DeviceManagerThread::ScheduleTicks(Notifier* notify, UInt64 ticksMks)
+{
+    if (!TicksNotifiers.Contains(notify))
+        return false;
+    TicksNotifiers.Schedule(notify, ticksMks);
+    return true;
+}
+
+bool DeviceManagerThread::AddMessageNotifier(Notifier* notify)
+{
+    MessageNotifiers.PushBack(notify);
+    return true;
+}
+
+bool DeviceManagerThread::RemoveMessageNotifier(Notifier* notify)
+{
+    for (UPInt i = 0; i < MessageNotifiers.GetSize(); i++)
+    {
+        if (MessageNotifiers[i] == notify)
+        {
+            MessageNotifiers.RemoveAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeviceManagerThread::OnDeviceMessage(Notifier::DeviceMessageType type, const String& devicePath)
+{
+    bool error = false;
+
+    for (UPInt i = 0; i < MessageNotifiers.GetSize(); i++)
+    {
+        if (MessageNotifiers[i] &&
+            MessageNotifiers[i]->OnDeviceMessage(type, devicePath, &error))
+        {
+            // The notifier belonged to a device with the specified device name so we're done.
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Linux
+
+
+//-------------------------------------------------------------------------------------
+// ***** Creation
+
+
+// Creates a new DeviceManager and initializes OVR.
+DeviceManager* DeviceManager::Create()
+{
+
+    if (!System::IsInitialized())
+    {
+        // Use custom message, since Log is not yet installed.
+        OVR_DEBUG_STATEMENT(Log::GetDefaultLog()->
+            LogMessage(Log_Debug, "DeviceManager::Create failed - OVR::System not initialized"); );
+        return 0;
+    }
+
+    Ptr<Linux::DeviceManager> manager = *new Linux::DeviceManager;
+
+    if (manager)
+    {
+        if (manager->Initialize(0))
+        {
+            manager->AddFactory(&SensorDeviceFactory::Instance);
+            manager->AddFactory(&LatencyTestDeviceFactory::Instance);
+            manager->AddFactory(&Linux::HMDDeviceFactory::Instance);
+
+            manager->AddRef();
+        }
+        else
+        {
+            manager.Clear();
+        }
+
+    }
+
+    return manager.GetPtr();
+}
+
+
+} // namespace OVR
@@ -0,0 +1,157 @@
+/************************************************************************************
+
+Filename    :   OVR_Linux_DeviceManager.h
+Content     :   Linux specific DeviceManager header.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#ifndef OVR_Linux_DeviceManager_h
+#define OVR_Linux_DeviceManager_h
+
+#include "OVR_DeviceImpl.h"
+#include "OVR_DeadlineQueue.h"
+
+#include "Kernel/OVR_Timer.h"
+
+
+namespace OVR { namespace Linux {
+
+class DeviceManagerThread;
+
+//-------------------------------------------------------------------------------------
+// ***** Linux DeviceManager
+
+class DeviceManager : public DeviceManagerImpl
+{
+public:
+    DeviceManager();
+    ~DeviceManager();
+
+    // Initialize/Shutdown manager thread.
+    virtual bool Initialize(DeviceBase* parent);
+    virtual void Shutdown();
+
+    virtual ThreadCommandQueue* GetThreadQueue();
+    virtual ThreadId GetThreadId() const;
+
+    virtual DeviceEnumerator<> EnumerateDevicesEx(const DeviceEnumerationArgs& args);
+
+    virtual bool  GetDeviceInfo(DeviceInfo* info) const;
+
+    // Fills HIDDeviceDesc by using the path.
+    // Returns 'true' if successful, 'false' otherwise.
+    bool GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const;
+
+    // Prefix for the /sys and /dev paths devices are found under: the value of
+    // OVR_HIDRAW_ROOT, which points the backend at a fake tree for testing, or "".
+    static const char* GetSysRoot();
+
+    // Reads a whole sysfs attribute; returns the number of bytes read, or -1.
+    static int  ReadSysFile(const String& path, UByte* buffer, int bufferSize);
+
+    Ptr<DeviceManagerThread> pThread;
+};
+
+//-------------------------------------------------------------------------------------
+// ***** Device Manager Background Thread
+
+// The thread sleeps in epoll_wait on the file descriptors of the devices it services,
+// plus an eventfd that is signaled when commands are queued.
+
+class DeviceManagerThread : public Thread, public ThreadCommandQueue
+{
+    friend class DeviceManager;
+    enum { ThreadStackSize = 32 * 1024 };
+public:
+    DeviceManagerThread();
+    ~DeviceManagerThread();
+
+    virtual int Run();
+
+    // ThreadCommandQueue notifications for CommandEvent handling.
+    virtual void OnPushNonEmpty_Locked();
+    virtual void OnPopEmpty_Locked()     { }
+
+
+    // Notifier used for different updates (file descriptor, regular timing or messages).
+    class Notifier
+    {
+    public:
+        // Called when a file descriptor added with AddSelectFd is readable, or has
+        // been hung up.
+        virtual void    OnEvent(int fd) { OVR_UNUSED1(fd); }
+
+        // Called once the notifier's tick deadline has passed.
+        // Returns the largest number of microseconds this function can
+        // wait till next call; that sets the next deadline.
+        virtual UInt64  OnTicks(UInt64 ticksMks)
+        { OVR_UNUSED1(ticksMks);  return Timer::MksPerSecond * 1000; }
+
+        enum DeviceMessageType
+        {
+            DeviceMessage_DeviceAdded     = 0,
+            DeviceMessage_DeviceRemoved   = 1,
+        };
+
+        // Called to notify device object.
+        virtual bool    OnDeviceMessage(DeviceMessageType messageType,
+                                        const String& devicePath,
+                                        bool* error)
+        { OVR_UNUSED3(messageType, devicePath, error); return false; }
+    };
+
+
+    // Adds a file descriptor to wait on. Notifier's OnEvent is called on this
+    // thread whenever the descriptor becomes readable.
+    bool AddSelectFd(Notifier* notify, int fd);
+    bool RemoveSelectFd(Notifier* notify, int fd);
+
+    // Add notifier that will be called at regular intervals. Its first
+    // OnTicks call happens on the next pass through the thread loop.
+    bool AddTicksNotifier(Notifier* notify);
+    bool RemoveTicksNotifier(Notifier* notify);
+
+    // Moves notifier's next OnTicks call to the absolute time ticksMks
+    // (Timer::GetTicks), e.g. 0 for as soon as possible.
+    // Returns 'false' if the notifier isn't registered.
+    bool ScheduleTicks(Notifier* notify, UInt64 ticksMks);
+
+    bool AddMessageNotifier(Notifier* notify);
+    bool RemoveMessageNotifier(Notifier* notify);
+
+    // Passes a hot-plug message to the message notifiers. Returns 'true' if one of
+    // them owns the device at devicePath.
+    bool OnDeviceMessage(Notifier::DeviceMessageType type, const String& devicePath);
+
+private:
+    bool threadInitialized() { return EpollFd >= 0 && CommandFd >= 0; }
+
+    // Drains CommandFd after it wakes us up.
+    void clearCommandEvent();
+
+    int                     EpollFd;
+    // eventfd written when thread commands are enqueued.
+    int                     CommandFd;
+
+    // File descriptors we wait on, other than CommandFd, and who services them.
+    Array<int>              SelectFds;
+    Array<Notifier*>        SelectNotifiers;
+
+    // Ticks notifiers - used for time-dependent events such as keep-alive,
+    // ordered by when each wants its next OnTicks call.
+    DeadlineQueue<Notifier*> TicksNotifiers;
+
+    // Message notifiers.
+    Array<Notifier*>        MessageNotifiers;
+};
+
+}} // namespace Linux::OVR
+
+#endif // OVR_Linux_DeviceManager_h
@@ -0,0 +1,675 @@
+/************************************************************************************
+
+Filename    :   OVR_Linux_HIDDevice.cpp
+Content     :   Linux HID device implementation.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_Linux_HIDDevice.h"
+#include "OVR_Linux_DeviceManager.h"
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Log.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+namespace OVR { namespace Linux {
+
+//-------------------------------------------------------------------------------------
+// Reads a text attribute, without the trailing newline.
+static bool readSysString(const String& path, String* result)
+{
+    char buffer[256];
+    int  size = DeviceManager::ReadSysFile(path, (UByte*)buffer, sizeof(buffer) - 1);
+    if (size < 0)
+        return false;
+
+    while (size > 0 && (buffer[size - 1] == '\n' || buffer[size - 1] == '\r'))
+        size--;
+    buffer[size] = 0;
+    *result = buffer;
+    return true;
+}
+
+// Finds the Usage Page and Usage of the first (application) collection in a HID
+// report descriptor.
+static bool parseTopLevelUsage(const UByte* data, int size, HIDDeviceDesc* desc)
+{
+    bool havePage  = false;
+    bool haveUsage = false;
+    int  i = 0;
+
+    while (i < size)
+    {
+        UByte prefix = data[i];
+
+        // Long items carry their size in the next byte; nothing we need is one.
+        if (prefix == 0xFE)
+        {
+            if (i + 1 >= size)
+                break;
+            i += 3 + data[i + 1];
+            continue;
+        }
+
+        int dataSize = prefix & 3;
+        if (dataSize == 3)
+            dataSize = 4;
+        if (i + 1 + dataSize > size)
+            break;
+
+        UInt32 value = 0;
+        for (int k = 0; k < dataSize; k++)
+            value |= (UInt32)data[i + 1 + k] << (8 * k);
+
+        switch (prefix & 0xFC)
+        {
+        case 0x04:  // Usage Page
+            desc->UsagePage = (UInt16)value;
+            havePage = true;
+            break;
+        case 0x08:  // Usage; a 4-byte one includes its page.
+            if (dataSize == 4)
+            {
+                desc->UsagePage = (UInt16)(value >> 16);
+                havePage = true;
+            }
+            desc->Usage = (UInt16)value;
+            haveUsage = true;
+            break;
+        case 0xA0:  // Collection
+            return havePage && haveUsage;
+        }
+        i += 1 + dataSize;
+    }
+    return havePage && haveUsage;
+}
+
+
+//-------------------------------------------------------------------------------------
+// **** Linux::HIDDeviceManager
+
+HIDDeviceManager::HIDDeviceManager(DeviceManager* manager)
+ :  Manager(manager), hUdevLib(0), Udev(0), Monitor(0), MonitorFd(-1)
+{
+    const char* root = DeviceManager::GetSysRoot();
+
+    SysClassPath = String(root) + "/sys/class/hidraw";
+    DevPath      = String(root) + "/dev";
+
+    // udev only knows the real device tree.
+    if (!*root)
+        hUdevLib = ::dlopen("libudev.so.1", RTLD_NOW | RTLD_LOCAL);
+
+    if (hUdevLib)
+    {
+        OVR_RESOLVE_UDEVFUNC(udev_new);
+        OVR_RESOLVE_UDEVFUNC(udev_unref);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_new_from_netlink);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_filter_add_match_subsystem_devtype);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_enable_receiving);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_get_fd);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_receive_device);
+        OVR_RESOLVE_UDEVFUNC(udev_monitor_unref);
+        OVR_RESOLVE_UDEVFUNC(udev_device_get_action);
+        OVR_RESOLVE_UDEVFUNC(udev_device_get_sysname);
+        OVR_RESOLVE_UDEVFUNC(udev_device_unref);
+    }
+}
+
+HIDDeviceManager::~HIDDeviceManager()
+{
+    OVR_ASSERT(!Monitor);
+    if (hUdevLib)
+        ::dlclose(hUdevLib);
+}
+
+bool HIDDeviceManager::Initialize()
+{
+    return true;
+}
+
+void HIDDeviceManager::Shutdown()
+{
+    LogText("OVR::Linux::HIDDeviceManager - shutting down.\n");
+}
+
+bool HIDDeviceManager::StartMonitoring()
+{
+    if (!hUdevLib || !udev_new || !udev_unref || !udev_monitor_new_from_netlink ||
+        !udev_monitor_filter_add_match_subsystem_devtype || !udev_monitor_enable_receiving ||
+        !udev_monitor_get_fd || !udev_monitor_receive_device || !udev_monitor_unref ||
+        !udev_device_get_action || !udev_device_get_sysname || !udev_device_unref)
+    {
+        LogText("OVR::Linux::HIDDeviceManager - libudev not available, no hot-plug detection.\n");
+        return false;
+    }
+
+    Udev = udev_new();
+    if (!Udev)
+        return false;
+
+    // The "udev" source reports devices after rules have set their permissions.
+    Monitor = udev_monitor_new_from_netlink(Udev, "udev");
+    if (!Monitor ||
+        udev_monitor_filter_add_match_subsystem_devtype(Monitor, "hidraw", 0) < 0 ||
+        udev_monitor_enable_receiving(Monitor) < 0 ||
+        (MonitorFd = udev_monitor_get_fd(Monitor)) < 0 ||
+        !Manager->pThread->AddSelectFd(this, MonitorFd))
+    {
+        LogError("OVR::Linux::HIDDeviceManager - failed to start udev monitor.\n");
+        MonitorFd = -1;
+        StopMonitoring();
+        return false;
+    }
+    return true;
+}
+
+bool HIDDeviceManager::StopMonitoring()
+{
+    if (MonitorFd >= 0)
+    {
+        Manager->pThread->RemoveSelectFd(this, MonitorFd);
+        MonitorFd = -1;
+    }
+    if (Monitor)
+    {
+        udev_monitor_unref(Monitor);
+        Monitor = 0;
+    }
+    if (Udev)
+    {
+        udev_unref(Udev);
+        Udev = 0;
+    }
+    return true;
+}
+
+void HIDDeviceManager::OnEvent(int fd)
+{
+    OVR_UNUSED(fd);
+    OVR_ASSERT(fd == MonitorFd);
+
+    udev_device* device;
+    while ((device = udev_monitor_receive_device(Monitor)) != 0)
+    {
+        const char* action  = udev_device_get_action(device);
+        const char* sysname = udev_device_get_sysname(device);
+
+        if (action && sysname)
+        {
+            String path = DevPath + "/" + sysname;
+
+            if (!strcmp(action, "add"))
+            {
+                // A device we already have open was plugged back in, or a new one.
+                if (!Manager->pThread->OnDeviceMessage(
+                        DeviceManagerThread::Notifier::DeviceMessage_DeviceAdded, path))
+                {
+                    HIDDeviceDesc devDesc;
+                    if (GetHIDDeviceDesc(path, &devDesc))
+                        Manager->DetectHIDDevice(devDesc);
+                }
+            }
+            else if (!strcmp(action, "remove"))
+            {
+                Manager->pThread->OnDeviceMessage(
+                    DeviceManagerThread::Notifier::DeviceMessage_DeviceRemoved, path);
+            }
+        }
+        udev_device_unref(device);
+    }
+}
+
+int HIDDeviceManager::OpenHIDFile(const char* path) const
+{
+    return ::open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+}
+
+bool HIDDeviceManager::getSysDir(const String& path, String* sysDir) const
+{
+    // Path must be DevPath/hidrawN.
+    const char* devicePath  = path.ToCStr();
+    UPInt       devPathSize = DevPath.GetSize();
+
+    if (strncmp(devicePath, DevPath.ToCStr(), devPathSize) || devicePath[devPathSize] != '/')
+        return false;
+
+    const char* name = devicePath + devPathSize + 1;
+    if (strncmp(name, "hidraw", 6) || strchr(name, '/'))
+        return false;
+
+    *sysDir = SysClassPath + "/" + name;
+    return true;
+}
+
+bool HIDDeviceManager::Enumerate(HIDEnumerateVisitor* enumVisitor)
+{
+    DIR* dir = ::opendir(SysClassPath.ToCStr());
+    if (!dir)
+        return false;
+
+    while (dirent* entry = ::readdir(dir))
+    {
+        if (strncmp(entry->d_name, "hidraw", 6))
+            continue;
+
+        HIDDeviceDesc devDesc;
+        String        sysDir = SysClassPath + "/" + entry->d_name;
+        devDesc.Path         = DevPath + "/" + entry->d_name;
+
+        // Look for the device to check if it is already opened.
+        Ptr<DeviceCreateDesc> existingDevice = Manager ? Manager->FindDevice(devDesc.Path) : 0;
+        // if device exists and it is opened then reading feature reports
+        // behind its back could interfere; therefore, we just set Enumerated
+        // to 'true' and continue.
+        if (existingDevice && existingDevice->pDevice)
+        {
+            existingDevice->Enumerated = true;
+            continue;
+        }
+
+        if (initVendorProductVersion(sysDir, &devDesc) &&
+            enumVisitor->MatchVendorProduct(devDesc.VendorId, devDesc.ProductId) &&
+            initUsage(sysDir, &devDesc))
+        {
+            initStrings(sysDir, &devDesc);
+
+            int hidDev = OpenHIDFile(devDesc.Path.ToCStr());
+            if (hidDev < 0)
+                continue;
+
+            // Construct minimal device that the visitor callback can get feature reports from.
+            Linux::HIDDevice device(this, hidDev);
+            enumVisitor->Visit(device, devDesc);
+
+            ::close(hidDev);
+        }
+    }
+
+    ::closedir(dir);
+    return true;
+}
+
+bool HIDDeviceManager::GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const
+{
+    String sysDir;
+    if (!getSysDir(path, &sysDir))
+        return false;
+
+    pdevDesc->Path = path;
+    return getFullDesc(sysDir, pdevDesc);
+}
+
+OVR::HIDDevice* HIDDeviceManager::Open(const String& path)
+{
+    Ptr<Linux::HIDDevice> device = *new Linux::HIDDevice(this);
+
+    if (device->HIDInitialize(path))
+    {
+        device->AddRef();
+        return device;
+    }
+
+    return NULL;
+}
+
+bool HIDDeviceManager::getFullDesc(const String& sysDir, HIDDeviceDesc* desc) const
+{
+    if (!initVendorProductVersion(sysDir, desc))
+    {
+        return false;
+    }
+
+    if (!initUsage(sysDir, desc))
+    {
+        return false;
+    }
+
+    initStrings(sysDir, desc);
+    return true;
+}
+
+bool HIDDeviceManager::initVendorProductVersion(const String& sysDir, HIDDeviceDesc* desc) const
+{
+    // uevent has a line "HID_ID=<bus>:<vendor>:<product>", all in hex.
+    char  uevent[1024];
+    int   size = DeviceManager::ReadSysFile(sysDir + "/device/uevent", (UByte*)uevent, sizeof(uevent) - 1);
+    if (size < 0)
+        return false;
+    uevent[size] = 0;
+
+    const char*  hidId = strstr(uevent, "HID_ID=");
+    unsigned int bus, vendor, product;
+    if (!hidId || sscanf(hidId, "HID_ID=%x:%x:%x", &bus, &vendor, &product) != 3)
+        return false;
+
+    desc->VendorId      = (UInt16)vendor;
+    desc->ProductId     = (UInt16)product;
+    desc->VersionNumber = 0;
+
+    // The USB device, two levels up, has the release number.
+    String version;
+    if (readSysString(sysDir + "/device/../../bcdDevice", &version))
+        desc->VersionNumber = (UInt16)strtoul(version.ToCStr(), 0, 16);
+
+    return true;
+}
+
+bool HIDDeviceManager::initUsage(const String& sysDir, HIDDeviceDesc* desc) const
+{
+    UByte reportDesc[HID_MAX_DESCRIPTOR_SIZE];
+    int   size = DeviceManager::ReadSysFile(sysDir + "/device/report_descriptor", reportDesc, sizeof(reportDesc));
+
+    return (size > 0) && parseTopLevelUsage(reportDesc, size, desc);
+}
+
+void HIDDeviceManager::initStrings(const String& sysDir, HIDDeviceDesc* desc) const
+{
+    // USB string descriptors live on the USB device. Failures leave strings empty,
+    // so it's ok to do this without further error checking.
+    readSysString(sysDir + "/device/../../manufacturer", &desc->Manufacturer);
+    readSysString(sysDir + "/device/../../product", &desc->Product);
+    readSysString(sysDir + "/device/../../serial", &desc->SerialNumber);
+}
+
+
+//-------------------------------------------------------------------------------------
+// **** Linux::HIDDevice
+
+HIDDevice::HIDDevice(HIDDeviceManager* manager)
+ : inMinimalMode(false), HIDManager(manager), Device(-1)
+{
+}
+
+// This is a minimal constructor used during enumeration for us to pass
+// a HIDDevice to the visit function (so that it can query feature reports).
+HIDDevice::HIDDevice(HIDDeviceManager* manager, int device)
+ : inMinimalMode(true), HIDManager(manager), Device(device)
+{
+}
+
+HIDDevice::~HIDDevice()
+{
+    if (!inMinimalMode)
+    {
+        HIDShutdown();
+    }
+}
+
+bool HIDDevice::HIDInitialize(const String& path)
+{
+    DevDesc.Path = path;
+
+    if (!openDevice())
+    {
+        LogText("OVR::Linux::HIDDevice - Failed to open HIDDevice: %s\n", path.ToCStr());
+        return false;
+    }
+
+    HIDManager->Manager->pThread->AddTicksNotifier(this);
+    HIDManager->Manager->pThread->AddMessageNotifier(this);
+
+    LogText("OVR::Linux::HIDDevice - Opened '%s'\n"
+        "                    Manufacturer:'%s'  Product:'%s'  Serial#:'%s'\n",
+        DevDesc.Path.ToCStr(),
+        DevDesc.Manufacturer.ToCStr(), DevDesc.Product.ToCStr(),
+        DevDesc.SerialNumber.ToCStr());
+
+    return true;
+}
+
+bool HIDDevice::initInfo()
+{
+    // Get device desc.
+    if (!HIDManager->GetHIDDeviceDesc(DevDesc.Path, &DevDesc))
+    {
+        OVR_ASSERT_LOG(false, ("Failed to get device desc while initializing device."));
+        return false;
+    }
+
+    return true;
+}
+
+bool HIDDevice::openDevice()
+{
+    Device = HIDManager->OpenHIDFile(DevDesc.Path.ToCStr());
+    if (Device < 0)
+    {
+        OVR_DEBUG_LOG(("Failed 'OpenHIDFile' while opening device, errno = %d.", errno));
+        return false;
+    }
+
+    if (!initInfo())
+    {
+        ::close(Device);
+        Device = -1;
+        return false;
+    }
+
+    if (!HIDManager->Manager->pThread->AddSelectFd(this, Device))
+    {
+        OVR_ASSERT_LOG(false, ("Failed to add HIDDevice to the device manager thread."));
+        ::close(Device);
+        Device = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void HIDDevice::HIDShutdown()
+{
+    HIDManager->Manager->pThread->RemoveTicksNotifier(this);
+    HIDManager->Manager->pThread->RemoveMessageNotifier(this);
+
+    closeDevice();
+    LogText("OVR::Linux::HIDDevice - Closed '%s'\n", DevDesc.Path.ToCStr());
+}
+
+void HIDDevice::closeDevice()
+{
+    if (Device < 0)
+        return;
+
+    HIDManager->Manager->pThread->RemoveSelectFd(this, Device);
+    ::close(Device);
+    Device = -1;
+}
+
+void HIDDevice::closeDeviceOnIOError()
+{
+    LogText("OVR::Linux::HIDDevice - Lost connection to '%s'\n", DevDesc.Path.ToCStr());
+    closeDevice();
+}
+
+bool HIDDevice::SetFeatureReport(UByte* data, UInt32 length)
+{
+    if (Device < 0)
+        return false;
+
+    return ::ioctl(Device, HIDIOCSFEATURE(length), data) >= 0;
+}
+
+bool HIDDevice::GetFeatureReport(UByte* data, UInt32 length)
+{
+    if (Device < 0)
+        return false;
+
+    return ::ioctl(Device, HIDIOCGFEATURE(length), data) >= 0;
+}
+
+void HIDDevice::OnEvent(int fd)
+{
+    OVR_UNUSED(fd);
+    OVR_ASSERT(fd == Device);
+
+    // hidraw returns one report per read; take all that have queued up.
+    while (Device >= 0)
+    {
+        ssize_t bytesRead = ::read(Device, ReadBuffer, ReadBufferSize);
+
+        if (bytesRead > 0)
+        {
+            if (Handler)
+            {
+                Handler->OnInputReport(ReadBuffer, (UInt32)bytesRead);
+            }
+        }
+        else if (bytesRead < 0 && (errno == EAGAIN || errno == EINTR))
+        {
+            if (errno == EAGAIN)
+                break;
+        }
+        else
+        {
+            // Unplugged, or some other error.
+            closeDeviceOnIOError();
+        }
+    }
+}
+
+void HIDDevice::RestartTicks()
+{
+    if (!inMinimalMode)
+        HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+}
+
+UInt64 HIDDevice::OnTicks(UInt64 ticksMks)
+{
+    if (Handler)
+    {
+        return Handler->OnTicks(ticksMks);
+    }
+
+    return DeviceManagerThread::Notifier::OnTicks(ticksMks);
+}
+
+bool HIDDevice::OnDeviceMessage(DeviceMessageType messageType,
+                                const String& devicePath,
+                                bool* error)
+{
+    // Is this the correct device?
+    if (DevDesc.Path.CompareNoCase(devicePath) != 0)
+    {
+        return false;
+    }
+
+    if (messageType == DeviceMessage_DeviceAdded && Device < 0)
+    {
+        // A closed device has been re-added. Try to reopen.
+        if (!openDevice())
+        {
+            LogError("OVR::Linux::HIDDevice - Failed to reopen a device '%s' that was re-added.\n", devicePath.ToCStr());
+            *error = true;
+            return true;
+        }
+
+        LogText("OVR::Linux::HIDDevice - Reopened device '%s'\n", devicePath.ToCStr());
+    }
+    else if (messageType == DeviceMessage_DeviceRemoved)
+    {
+        // Reads may not have failed yet.
+        closeDevice();
+    }
+
+    HIDHandler::HIDDeviceMessageType handlerMessageType = HIDHandler::HIDDeviceMessage_DeviceAdded;
+    if (messageType == DeviceMessage_DeviceAdded)
+    {
+    }
+    else if (messageType == DeviceMessage_DeviceRemoved)
+    {
+        handlerMessageType = HIDHandler::HIDDeviceMessage_DeviceRemoved;
+    }
+    else
+    {
+        OVR_ASSERT(0);
+    }
+
+    if (Handler)
+    {
+        Handler->OnDeviceMessage(handlerMessageType);
+    }
+
+    *error = false;
+    return true;
+}
+
+HIDDeviceManager* HIDDeviceManager::CreateInternal(Linux::DeviceManager* devManager)
+{
+
+    if (!System::IsInitialized())
+    {
+        // Use custom message, since Log is not yet installed.
+        OVR_DEBUG_STATEMENT(Log::GetDefaultLog()->
+            LogMessage(Log_Debug, "HIDDeviceManager::Create failed - OVR::System not initialized"); );
+        return 0;
+    }
+
+    Ptr<Linux::HIDDeviceManager> manager = *new Linux::HIDDeviceManager(devManager);
+
+    if (manager)
+    {
+        if (manager->Initialize())
+        {
+            manager->AddRef();
+        }
+        else
+        {
+            manager.Clear();
+        }
+    }
+
+    return manager.GetPtr();
+}
+
+} // namespace Linux
+
+//-------------------------------------------------------------------------------------
+// ***** Creation
+
+// Creates a new HIDDeviceManager and initializes OVR.
+HIDDeviceManager* HIDDeviceManager::Create()
+{
+    OVR_ASSERT_LOG(false, ("Standalone mode not implemented yet."));
+
+    if (!System::IsInitialized())
+    {
+        // Use custom message, since Log is not yet installed.
+        OVR_DEBUG_STATEMENT(Log::GetDefaultLog()->
+            LogMessage(Log_Debug, "HIDDeviceManager::Create failed - OVR::System not initialized"); );
+        return 0;
+    }
+
+    Ptr<Linux::HIDDeviceManager> manager = *new Linux::HIDDeviceManager(NULL);
+
+    if (manager)
+    {
+        if (manager->Initialize())
+        {
+            manager->AddRef();
+        }
+        else
+        {
+            manager.Clear();
+        }
+    }
+
+    return manager.GetPtr();
+}
+
+} // namespace OVR
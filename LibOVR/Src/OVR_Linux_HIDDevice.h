@@ -0,0 +1,167 @@
+/************************************************************************************
+
+Filename    :   OVR_Linux_HIDDevice.h
+Content     :   Linux HID device implementation.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#ifndef OVR_Linux_HIDDevice_h
+#define OVR_Linux_HIDDevice_h
+
+#include "OVR_HIDDevice.h"
+#include "OVR_Linux_DeviceManager.h"
+
+//-------------------------------------------------------------------------------------
+// Declare the libudev functionality we use, so that libudev headers aren't needed to
+// build and the library isn't needed to run; without it there is just no hot-plug.
+// #include <libudev.h>
+
+struct udev;
+struct udev_monitor;
+struct udev_device;
+
+
+namespace OVR { namespace Linux {
+
+class HIDDeviceManager;
+class DeviceManager;
+
+//-------------------------------------------------------------------------------------
+// ***** Linux HIDDevice
+
+// HIDDevice reads input reports from a hidraw node. The descriptor is non-blocking
+// and serviced by DeviceManagerThread through epoll.
+
+class HIDDevice : public OVR::HIDDevice, public DeviceManagerThread::Notifier
+{
+public:
+
+    HIDDevice(HIDDeviceManager* manager);
+
+    // This is a minimal constructor used during enumeration for us to pass
+    // a HIDDevice to the visit function (so that it can query feature reports).
+    HIDDevice(HIDDeviceManager* manager, int device);
+
+    ~HIDDevice();
+
+    bool HIDInitialize(const String& path);
+    void HIDShutdown();
+
+    // OVR::HIDDevice
+    bool SetFeatureReport(UByte* data, UInt32 length);
+    bool GetFeatureReport(UByte* data, UInt32 length);
+
+
+    // DeviceManagerThread::Notifier
+    void OnEvent(int fd);
+    UInt64 OnTicks(UInt64 ticksMks);
+    bool OnDeviceMessage(DeviceMessageType messageType, const String& devicePath, bool* error);
+
+private:
+    // OVR::HIDDevice
+    void RestartTicks();
+
+    bool openDevice();
+    bool initInfo();
+    void closeDevice();
+    void closeDeviceOnIOError();
+
+    bool                inMinimalMode;
+    HIDDeviceManager*   HIDManager;
+    int                 Device;
+    HIDDeviceDesc       DevDesc;
+
+    enum { ReadBufferSize = 96 };
+    UByte               ReadBuffer[ReadBufferSize];
+};
+
+//-------------------------------------------------------------------------------------
+// ***** Linux HIDDeviceManager
+
+// Devices are found through sysfs (/sys/class/hidraw) and opened as /dev/hidrawN,
+// which is also their Path. Setting the OVR_HIDRAW_ROOT environment variable puts
+// both directories (and /sys/class/drm, for HMD detection) under another root, so a
+// simulated device tree can stand in for the real one; hot-plug monitoring is off then.
+
+class HIDDeviceManager : public OVR::HIDDeviceManager, public DeviceManagerThread::Notifier
+{
+    friend class HIDDevice;
+public:
+
+    HIDDeviceManager(DeviceManager* manager);
+    virtual ~HIDDeviceManager();
+
+    virtual bool Initialize();
+    virtual void Shutdown();
+
+    virtual bool Enumerate(HIDEnumerateVisitor* enumVisitor);
+    virtual OVR::HIDDevice* Open(const String& path);
+
+    // Fills HIDDeviceDesc by using the path.
+    // Returns 'true' if successful, 'false' otherwise.
+    bool GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const;
+
+    // Start/stop delivering udev hot-plug events. Must be called on the
+    // DeviceManagerThread.
+    bool StartMonitoring();
+    bool StopMonitoring();
+
+    // DeviceManagerThread::Notifier
+    void OnEvent(int fd);
+
+    static HIDDeviceManager* CreateInternal(DeviceManager* manager);
+
+private:
+
+    DeviceManager* Manager;     // Back pointer can just be a raw pointer.
+
+    String  SysClassPath;       // Holds a directory per hidraw node.
+    String  DevPath;            // Holds the nodes themselves.
+
+    void*           hUdevLib;
+    udev*           Udev;
+    udev_monitor*   Monitor;
+    int             MonitorFd;
+
+    // Macros to declare and resolve needed functions from library.
+#define OVR_DECLARE_UDEVFUNC(func, rettype, args)   \
+typedef rettype (*PFn_##func) args;  \
+PFn_##func      func;
+#define OVR_RESOLVE_UDEVFUNC(func) \
+func = (PFn_##func)::dlsym(hUdevLib, #func)
+
+    OVR_DECLARE_UDEVFUNC(udev_new,                                  udev*,          (void));
+    OVR_DECLARE_UDEVFUNC(udev_unref,                                udev*,          (udev* udev));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_new_from_netlink,             udev_monitor*,  (udev* udev, const char* name));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_filter_add_match_subsystem_devtype, int,      (udev_monitor* monitor, const char* subsystem, const char* devtype));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_enable_receiving,             int,            (udev_monitor* monitor));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_get_fd,                       int,            (udev_monitor* monitor));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_receive_device,               udev_device*,   (udev_monitor* monitor));
+    OVR_DECLARE_UDEVFUNC(udev_monitor_unref,                        udev_monitor*,  (udev_monitor* monitor));
+    OVR_DECLARE_UDEVFUNC(udev_device_get_action,                    const char*,    (udev_device* device));
+    OVR_DECLARE_UDEVFUNC(udev_device_get_sysname,                   const char*,    (udev_device* device));
+    OVR_DECLARE_UDEVFUNC(udev_device_unref,                         udev_device*,   (udev_device* device));
+
+    int OpenHIDFile(const char* path) const;
+
+    // Helper functions to fill in HIDDeviceDesc from the device's sysfs directory.
+    bool initVendorProductVersion(const String& sysDir, HIDDeviceDesc* desc) const;
+    bool initUsage(const String& sysDir, HIDDeviceDesc* desc) const;
+    void initStrings(const String& sysDir, HIDDeviceDesc* desc) const;
+
+    bool getFullDesc(const String& sysDir, HIDDeviceDesc* desc) const;
+
+    // Maps /dev/hidrawN to its sysfs directory, or returns false if path isn't ours.
+    bool getSysDir(const String& path, String* sysDir) const;
+};
+
+}} // namespace OVR::Linux
+
+#endif // OVR_Linux_HIDDevice_h
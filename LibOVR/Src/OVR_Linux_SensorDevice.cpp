@@ -0,0 +1,44 @@
+/************************************************************************************
+
+Filename    :   OVR_Linux_SensorDevice.cpp
+Content     :   Linux SensorDevice implementation
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_Linux_HMDDevice.h"
+#include "OVR_SensorImpl.h"
+#include "OVR_DeviceImpl.h"
+
+namespace OVR { namespace Linux {
+
+} // namespace Linux
+
+//-------------------------------------------------------------------------------------
+void SensorDeviceImpl::EnumerateHMDFromSensorDisplayInfo(   const SensorDisplayInfoImpl& displayInfo, 
+                                                            DeviceFactory::EnumerateVisitor& visitor)
+{
+
+    Linux::HMDDeviceCreateDesc hmdCreateDesc(&Linux::HMDDeviceFactory::Instance, 1, 1, "", 0);
+    
+    hmdCreateDesc.SetScreenParameters(  0, 0,
+                                        displayInfo.HResolution, displayInfo.VResolution,
+                                        displayInfo.HScreenSize, displayInfo.VScreenSize);
+
+    if ((displayInfo.DistortionType & SensorDisplayInfoImpl::Mask_BaseFmt) == SensorDisplayInfoImpl::Base_Distortion)
+        hmdCreateDesc.SetDistortion(displayInfo.DistortionK);
+    if (displayInfo.HScreenSize > 0.14f)
+        hmdCreateDesc.Set7Inch();
+
+    visitor.Visit(hmdCreateDesc);
+}
+
+} // namespace OVR
+
+
@@ -196,19 +196,14 @@ int DeviceManagerThread::Run()
 
                 UInt32 waitMs = INT_MAX;
 
-                // If devices have time-dependent logic registered, get the longest wait
-                // allowed based on current ticks.
-                if (!TicksNotifiers.IsEmpty())
+                // If devices have time-dependent logic registered, run the ones that
+                // are due and sleep until the next deadline. Rounding up keeps us from
+                // waking just short of it.
+                UInt64 waitMks = TicksNotifiers.RunDue(Timer::GetTicks(), &Notifier::OnTicks);
+                if (waitMks != ~UInt64(0))
                 {
-                    UInt64 ticksMks = Timer::GetTicks();
-                    UInt32  waitAllowed;
-
-                    for (UPInt j = 0; j < TicksNotifiers.GetSize(); j++)
-                    {
-                        waitAllowed = (UInt32)(TicksNotifiers[j]->OnTicks(ticksMks) / Timer::MksPerMs);
-                        if (waitAllowed < waitMs)
-                            waitMs = waitAllowed;
-                    }
+                    UInt64 waitAllowed = waitMks / Timer::MksPerMs + ((waitMks % Timer::MksPerMs) ? 1 : 0);
+                    waitMs = (waitAllowed > INT_MAX) ? INT_MAX : (UInt32)waitAllowed;
                 }
                 
                 // Enter blocking run loop. We may continue until we timeout in which
@@ -272,21 +267,22 @@ void DeviceManagerThread::commandQueueSourceCallback()
 
 bool DeviceManagerThread::AddTicksNotifier(Notifier* notify)
 {
-     TicksNotifiers.PushBack(notify);
-     return true;
+    if (!TicksNotifiers.Contains(notify))
+        TicksNotifiers.Schedule(notify, 0);
+    return true;
 }
 
 bool DeviceManagerThread::RemoveTicksNotifier(Notifier* notify)
 {
-    for (UPInt i = 0; i < TicksNotifiers.GetSize(); i++)
-    {
-        if (TicksNotifiers[i] == notify)
-        {
-            TicksNotifiers.RemoveAt(i);
-            return true;
-        }
-    }
-    return false;
+    return TicksNotifiers.Remove(notify);
+}
+
+bool DeviceManagerThread::ScheduleTicks(Notifier* notify, UInt64 ticksMks)
+{
+    if (!TicksNotifiers.Contains(notify))
+        return false;
+    TicksNotifiers.Schedule(notify, ticksMks);
+    return true;
 }
 
 void DeviceManagerThread::Shutdown()
@@ -17,6 +17,7 @@ otherwise accompanies this software in either electronic or hard copy form.
 #define OVR_OSX_DeviceManager_h
 
 #include "OVR_DeviceImpl.h"
+#include "OVR_DeadlineQueue.h"
 
 #include "Kernel/OVR_Timer.h"
 
@@ -92,10 +93,16 @@ public:
         { OVR_UNUSED1(ticksMks);  return Timer::MksPerSecond * 1000; }
     };
  
-    // Add notifier that will be called at regular intervals. 
+    // Add notifier that will be called at regular intervals. Its first
+    // OnTicks call happens on the next pass through the thread loop.
     bool AddTicksNotifier(Notifier* notify);
     bool RemoveTicksNotifier(Notifier* notify);
 
+    // Moves notifier's next OnTicks call to the absolute time ticksMks
+    // (Timer::GetTicks), e.g. 0 for as soon as possible.
+    // Returns 'false' if the notifier isn't registered.
+    bool ScheduleTicks(Notifier* notify, UInt64 ticksMks);
+
     CFRunLoopRef        GetRunLoop()
     { return RunLoop; }
     
@@ -110,8 +117,9 @@ private:
 
     Event               StartupEvent;
     
-    // Ticks notifiers. Used for time-dependent events such as keep-alive.
-    Array<Notifier*>    TicksNotifiers;
+    // Ticks notifiers - used for time-dependent events such as keep-alive,
+    // ordered by when each wants its next OnTicks call.
+    DeadlineQueue<Notifier*> TicksNotifiers;
 };
 
 }} // namespace OSX::OVR
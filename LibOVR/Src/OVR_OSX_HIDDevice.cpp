@@ -822,6 +822,12 @@ bool HIDDevice::GetFeatureReport(UByte* data, UInt32 length)
     return (result == kIOReturnSuccess);
 }
    
+void HIDDevice::RestartTicks()
+{
+    if (!InMinimalMode)
+        HIDManager->DevManager->pThread->ScheduleTicks(this, 0);
+}
+
 UInt64 HIDDevice::OnTicks(UInt64 ticksMks)
 {
     
@@ -58,6 +58,9 @@ public:
     UInt64 OnTicks(UInt64 ticksMks);
     
 private:
+    // OVR::HIDDevice
+    void RestartTicks();
+
     bool initInfo();
     bool openDevice();
     void closeDevice(bool wasUnplugged);
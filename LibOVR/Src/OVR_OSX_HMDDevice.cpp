@@ -50,6 +50,7 @@ HMDDeviceCreateDesc::HMDDeviceCreateDesc(const HMDDeviceCreateDesc& other)
           HScreenSize(other.HScreenSize), VScreenSize(other.VScreenSize),
           DisplayId(other.DisplayId)
 {
+    memcpy(DistortionK, other.DistortionK, sizeof(float)*4);
 }
 
 HMDDeviceCreateDesc::MatchResult HMDDeviceCreateDesc::MatchDevice(const DeviceCreateDesc& other,
@@ -16,106 +16,130 @@ otherwise accompanies this software in either electronic or hard copy form.
 
 #include "OVR_SensorFilter.h"
 
+#include <string.h>
+
 namespace OVR {
 
-Vector3f SensorFilter::Total() const
+void SensorFilter::Init(int size)
 {
-    Vector3f total = Vector3f(0.0f, 0.0f, 0.0f);
-    for (int i = 0; i < Size; i++)
-        total += Elements[i];
-    return total;
+    LastIdx = -1;
+    Size = size;
+    memset(X, 0, sizeof(X));
+    memset(Y, 0, sizeof(Y));
+    memset(Z, 0, sizeof(Z));
+    SumX = SumY = SumZ = 0;
+    SumXX = SumYY = SumZZ = 0;
+    SumXY = SumYZ = SumZX = 0;
 }
 
-Vector3f SensorFilter::Mean() const
+// Recomputes the running sums from the window contents.
+void SensorFilter::Resum()
 {
-    Vector3f total = Vector3f(0.0f, 0.0f, 0.0f);
+    double sx = 0, sy = 0, sz = 0, sxx = 0, syy = 0, szz = 0, sxy = 0, syz = 0, szx = 0;
     for (int i = 0; i < Size; i++)
-        total += Elements[i];
-    return total / (float) Size;
+    {
+        double x = X[i], y = Y[i], z = Z[i];
+        sx  += x;     sy  += y;     sz  += z;
+        sxx += x * x; syy += y * y; szz += z * z;
+        sxy += x * y; syz += y * z; szx += z * x;
+    }
+    SumX = sx;   SumY = sy;   SumZ = sz;
+    SumXX = sxx; SumYY = syy; SumZZ = szz;
+    SumXY = sxy; SumYZ = syz; SumZX = szx;
 }
 
-Vector3f SensorFilter::Median() const
+Vector3f SensorFilter::Total() const
 {
-    int half_window = (int) Size / 2;
-    float sortx[MaxFilterSize];
-    float resultx = 0.0f;
+    return Vector3f((float) SumX, (float) SumY, (float) SumZ);
+}
 
-    float sorty[MaxFilterSize];
-    float resulty = 0.0f;
+Vector3f SensorFilter::Mean() const
+{
+    return Vector3f((float) (SumX / Size), (float) (SumY / Size), (float) (SumZ / Size));
+}
 
-    float sortz[MaxFilterSize];
-    float resultz = 0.0f;
+static inline void SwapFloat(float& a, float& b)
+{
+    float t = a;
+    a = b;
+    b = t;
+}
 
-    for (int i = 0; i < Size; i++) 
-    {
-        sortx[i] = Elements[i].x;
-        sorty[i] = Elements[i].y;
-        sortz[i] = Elements[i].z;
-    }
-    for (int j = 0; j <= half_window; j++) 
+// Returns the k-th smallest of a[0..n-1], reordering a (Hoare's selection).
+static float SelectKth(float* a, int n, int k)
+{
+    int lo = 0, hi = n - 1;
+    while (hi > lo)
     {
-        int minx = j;
-        int miny = j;
-        int minz = j;
-        for (int k = j + 1; k < Size; k++) 
+        // Median of three, which also guards both scans below
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < a[lo]) SwapFloat(a[mid], a[lo]);
+        if (a[hi] < a[lo])  SwapFloat(a[hi], a[lo]);
+        if (a[hi] < a[mid]) SwapFloat(a[hi], a[mid]);
+
+        float pivot = a[mid];
+        int   i = lo, j = hi;
+        while (i <= j)
         {
-            if (sortx[k] < sortx[minx]) minx = k;
-            if (sorty[k] < sorty[miny]) miny = k;
-            if (sortz[k] < sortz[minz]) minz = k;
+            while (a[i] < pivot) i++;
+            while (pivot < a[j]) j--;
+            if (i <= j)
+            {
+                SwapFloat(a[i], a[j]);
+                i++;
+                j--;
+            }
         }
-        const float tempx = sortx[j];
-        const float tempy = sorty[j];
-        const float tempz = sortz[j];
-        sortx[j] = sortx[minx];
-        sortx[minx] = tempx;
-
-        sorty[j] = sorty[miny];
-        sorty[miny] = tempy;
 
-        sortz[j] = sortz[minz];
-        sortz[minz] = tempz;
+        // a[lo..j] <= pivot <= a[i..hi]; anything between equals the pivot
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            return a[k];
     }
-    resultx = sortx[half_window];
-    resulty = sorty[half_window];
-    resultz = sortz[half_window];
+    return a[k];
+}
 
-    return Vector3f(resultx, resulty, resultz);
+Vector3f SensorFilter::Median() const
+{
+    int half_window = (int) Size / 2;
+    float sortx[MaxFilterSize];
+    float sorty[MaxFilterSize];
+    float sortz[MaxFilterSize];
+
+    memcpy(sortx, X, Size * sizeof(float));
+    memcpy(sorty, Y, Size * sizeof(float));
+    memcpy(sortz, Z, Size * sizeof(float));
+
+    return Vector3f(SelectKth(sortx, Size, half_window),
+                    SelectKth(sorty, Size, half_window),
+                    SelectKth(sortz, Size, half_window));
 }
 
 //  Only the diagonal of the covariance matrix.
 Vector3f SensorFilter::Variance() const
 {
-    Vector3f mean = Mean();
-    Vector3f total = Vector3f(0.0f, 0.0f, 0.0f);
-    for (int i = 0; i < Size; i++) 
-    {
-        total.x += (Elements[i].x - mean.x) * (Elements[i].x - mean.x);
-        total.y += (Elements[i].y - mean.y) * (Elements[i].y - mean.y);
-        total.z += (Elements[i].z - mean.z) * (Elements[i].z - mean.z);
-    }
-    return total / (float) Size;
+    // E[x^2] - E[x]^2 can come out fractionally negative when the window is constant
+    double mx = SumX / Size, my = SumY / Size, mz = SumZ / Size;
+    double vx = SumXX / Size - mx * mx, vy = SumYY / Size - my * my, vz = SumZZ / Size - mz * mz;
+    return Vector3f((float) (vx > 0 ? vx : 0), (float) (vy > 0 ? vy : 0), (float) (vz > 0 ? vz : 0));
 }
 
 // Should be a 3x3 matrix returned, but OVR_math.h doesn't have one
 Matrix4f SensorFilter::Covariance() const
 {
-    Vector3f mean = Mean();
+    double   mx = SumX / Size, my = SumY / Size, mz = SumZ / Size;
+    Vector3f var = Variance();
     Matrix4f total = Matrix4f(0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0);
-    for (int i = 0; i < Size; i++) 
-    {
-        total.M[0][0] += (Elements[i].x - mean.x) * (Elements[i].x - mean.x);
-        total.M[1][0] += (Elements[i].y - mean.y) * (Elements[i].x - mean.x);
-        total.M[2][0] += (Elements[i].z - mean.z) * (Elements[i].x - mean.x);
-        total.M[1][1] += (Elements[i].y - mean.y) * (Elements[i].y - mean.y);
-        total.M[2][1] += (Elements[i].z - mean.z) * (Elements[i].y - mean.y);
-        total.M[2][2] += (Elements[i].z - mean.z) * (Elements[i].z - mean.z);
-    }
-    total.M[0][1] = total.M[1][0];
-    total.M[0][2] = total.M[2][0];
-    total.M[1][2] = total.M[2][1];
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            total.M[i][j] *= 1.0f / Size;
+
+    total.M[0][0] = var.x;
+    total.M[1][1] = var.y;
+    total.M[2][2] = var.z;
+    total.M[1][0] = total.M[0][1] = (float) (SumXY / Size - mx * my);
+    total.M[2][1] = total.M[1][2] = (float) (SumYZ / Size - my * mz);
+    total.M[2][0] = total.M[0][2] = (float) (SumZX / Size - mz * mx);
     return total;
 }
 
@@ -131,64 +155,82 @@ Vector3f SensorFilter::PearsonCoefficient() const
 }
 
 
+// Terms are added newest first, in the order the filters were written
+// out by hand, so results are unchanged.  With a constant n the loop unrolls.
+static inline Vector3f convolveWindow(const float* x, const float* y, const float* z,
+                                      const float* taps, int n)
+{
+    float rx = x[0] * taps[0], ry = y[0] * taps[0], rz = z[0] * taps[0];
+    for (int i = 1; i < n; i++)
+    {
+        rx += x[-i] * taps[i];
+        ry += y[-i] * taps[i];
+        rz += z[-i] * taps[i];
+    }
+    return Vector3f(rx, ry, rz);
+}
+
+Vector3f SensorFilter::Convolve(const float* taps, int n) const
+{
+    OVR_ASSERT(n >= 1 && n <= Size);
+    int newest = LastIdx + Size;
+    return convolveWindow(X + newest, Y + newest, Z + newest, taps, n);
+}
+
+
+// Taps for the fixed-size filters, newest element first
+static const float SavitzkyGolaySmooth8Taps[8] =
+    { 0.41667f, 0.33333f, 0.25f, 0.16667f, 0.08333f, 0.0f, -0.08333f, -0.16667f };
+static const float SavitzkyGolayDerivative4Taps[4] =
+    { 0.3f, 0.1f, -0.1f, -0.3f };
+static const float SavitzkyGolayDerivative5Taps[5] =
+    { 0.2f, 0.1f, 0.0f, -0.1f, -0.2f };
+static const float SavitzkyGolayDerivative12Taps[12] =
+    { 0.03846f, 0.03147f, 0.02448f, 0.01748f, 0.01049f, 0.0035f,
+     -0.0035f, -0.01049f, -0.01748f, -0.02448f, -0.03147f, -0.03846f };
+
 Vector3f SensorFilter::SavitzkyGolaySmooth8() const
 {
     OVR_ASSERT(Size >= 8);
-    return GetPrev(0)*0.41667f +
-            GetPrev(1)*0.33333f +
-            GetPrev(2)*0.25f +
-            GetPrev(3)*0.16667f +
-            GetPrev(4)*0.08333f -
-            GetPrev(6)*0.08333f -
-            GetPrev(7)*0.16667f;
+    int newest = LastIdx + Size;
+    return convolveWindow(X + newest, Y + newest, Z + newest, SavitzkyGolaySmooth8Taps, 8);
 }
 
 
 Vector3f SensorFilter::SavitzkyGolayDerivative4() const
 {
     OVR_ASSERT(Size >= 4);
-    return GetPrev(0)*0.3f +
-            GetPrev(1)*0.1f -
-            GetPrev(2)*0.1f -
-            GetPrev(3)*0.3f;
+    int newest = LastIdx + Size;
+    return convolveWindow(X + newest, Y + newest, Z + newest, SavitzkyGolayDerivative4Taps, 4);
 }
 
 Vector3f SensorFilter::SavitzkyGolayDerivative5() const
 {
     OVR_ASSERT(Size >= 5);
-    return GetPrev(0)*0.2f +
-            GetPrev(1)*0.1f -
-            GetPrev(3)*0.1f -
-            GetPrev(4)*0.2f;
+    int newest = LastIdx + Size;
+    return convolveWindow(X + newest, Y + newest, Z + newest, SavitzkyGolayDerivative5Taps, 5);
 }
 
 Vector3f SensorFilter::SavitzkyGolayDerivative12() const
 {
     OVR_ASSERT(Size >= 12);
-    return GetPrev(0)*0.03846f +
-            GetPrev(1)*0.03147f +
-            GetPrev(2)*0.02448f +
-            GetPrev(3)*0.01748f +
-            GetPrev(4)*0.01049f +
-            GetPrev(5)*0.0035f -
-            GetPrev(6)*0.0035f -
-            GetPrev(7)*0.01049f -
-            GetPrev(8)*0.01748f -
-            GetPrev(9)*0.02448f -
-            GetPrev(10)*0.03147f -
-            GetPrev(11)*0.03846f;
+    int newest = LastIdx + Size;
+    return convolveWindow(X + newest, Y + newest, Z + newest, SavitzkyGolayDerivative12Taps, 12);
 }
 
 Vector3f SensorFilter::SavitzkyGolayDerivativeN(int n) const
 {    
     OVR_ASSERT(Size >= n);
     int m = (n-1)/2;
+    const float* x = X + LastIdx + Size;
+    const float* y = Y + LastIdx + Size;
+    const float* z = Z + LastIdx + Size;
     Vector3f result = Vector3f();
     for (int k = 1; k <= m; k++) 
     {
         int ind1 = m - k;
         int ind2 = n - m + k - 1;
-        result += (GetPrev(ind1) - GetPrev(ind2)) * (float) k;
+        result += Vector3f(x[-ind1] - x[-ind2], y[-ind1] - y[-ind2], z[-ind1] - z[-ind2]) * (float) k;
     }
     float coef = 3.0f/(m*(m+1.0f)*(2.0f*m+1.0f));
     result = result*coef;
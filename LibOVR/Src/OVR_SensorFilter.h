@@ -35,22 +35,36 @@ class SensorFilter
 private:
     int         LastIdx;                    // The index of the last element that was added to the array
     int         Size;                       // The window size (number of elements)
-    Vector3f    Elements[MaxFilterSize]; 
+
+    // Elements by component, so each statistic runs over contiguous floats.
+    // Each element is also mirrored at [i + Size], so the window ending at
+    // the newest element, [LastIdx + 1, LastIdx + Size], never wraps.
+    float       X[2 * MaxFilterSize];
+    float       Y[2 * MaxFilterSize];
+    float       Z[2 * MaxFilterSize];
+
+    // Sums over the window, updated as elements are added.  They are kept in
+    // double and recomputed once per pass through the ring, so adding the new
+    // element and removing the one it replaces doesn't accumulate error.
+    double      SumX, SumY, SumZ;
+    double      SumXX, SumYY, SumZZ;
+    double      SumXY, SumYZ, SumZX;
+
+    void        Init(int size);
+    void        Resum();
 
 public:
     // Create a new filter with default size
     SensorFilter() 
     {
-        LastIdx = -1;
-        Size = DefaultFilterSize;
+        Init(DefaultFilterSize);
     };
 
     // Create a new filter with size i
     SensorFilter(int i) 
     {
         OVR_ASSERT(i <= MaxFilterSize);
-        LastIdx = -1;
-        Size = i;
+        Init(i);
     };
 
 
@@ -62,21 +76,45 @@ public:
         else                            
             LastIdx++;
 
-        Elements[LastIdx] = e;
+        double ox = X[LastIdx], oy = Y[LastIdx], oz = Z[LastIdx];
+        X[LastIdx] = X[LastIdx + Size] = e.x;
+        Y[LastIdx] = Y[LastIdx + Size] = e.y;
+        Z[LastIdx] = Z[LastIdx + Size] = e.z;
+
+        if (LastIdx == 0)
+        {
+            Resum();
+            return;
+        }
+
+        double x = e.x, y = e.y, z = e.z;
+        SumX  += x - ox;
+        SumY  += y - oy;
+        SumZ  += z - oz;
+        SumXX += x * x - ox * ox;
+        SumYY += y * y - oy * oy;
+        SumZZ += z * z - oz * oz;
+        SumXY += x * y - ox * oy;
+        SumYZ += y * z - oy * oz;
+        SumZX += z * x - oz * ox;
     };
 
     // Get element i.  0 is the most recent, 1 is one step ago, 2 is two steps ago, ...
     Vector3f GetPrev(int i) const
     {
 		OVR_ASSERT(i >= 0); // 
-        int idx = (LastIdx - i);
-        if (idx < 0) // Fix the wraparound case
-            idx += Size;
-		OVR_ASSERT(idx >= 0); // Multiple wraparounds not allowed
-        return Elements[idx];
+		OVR_ASSERT(i < Size); // Multiple wraparounds not allowed
+        int idx = LastIdx + Size - i;
+        return Vector3f(X[idx], Y[idx], Z[idx]);
     };
 
-    // Simple statistics
+    // Sum of taps[i] * GetPrev(i) for i < n, over the contiguous window.
+    // Terms are added newest first.
+    Vector3f Convolve(const float* taps, int n) const;
+
+    // Simple statistics.  Slots not yet filled count as zero.
+    // Total, Mean, Variance, Covariance and PearsonCoefficient are O(1);
+    // Median is a linear-time selection.
     Vector3f Total() const;
     Vector3f Mean() const;
     Vector3f Median() const;
@@ -84,7 +122,7 @@ public:
     Matrix4f Covariance() const;
     Vector3f PearsonCoefficient() const;
 
-    // A popular family of smoothing filters and smoothed derivatives
+    // A popular family of smoothing filters and smoothed derivatives, O(taps)
     Vector3f SavitzkyGolaySmooth8() const;
     Vector3f SavitzkyGolayDerivative4() const;
     Vector3f SavitzkyGolayDerivative5() const;
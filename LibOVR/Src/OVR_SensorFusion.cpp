@@ -16,6 +16,7 @@ otherwise accompanies this software in either electronic or hard copy form.
 #include "OVR_SensorFusion.h"
 #include "Kernel/OVR_Log.h"
 #include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
 
 namespace OVR {
 
@@ -25,7 +26,8 @@ namespace OVR {
 SensorFusion::SensorFusion(SensorDevice* sensor)
   : Handler(getThis()), pDelegate(0),
     Gain(0.05f), YawMult(1), EnableGravity(true), Stage(0), DeltaT(0.001f),
-	EnablePrediction(false), PredictionDT(0.03f),
+    RunningTime(0), SampleTime(0),
+	EnablePrediction(false), PredictionDT(0.03f), EnablePredictAcceleration(false),
     FRawMag(10), FAccW(20), FAngV(20),
     TiltCondCount(0), TiltErrorAngle(0), 
     TiltErrorAxis(0,1,0),
@@ -34,9 +36,12 @@ SensorFusion::SensorFusion(SensorDevice* sensor)
     YawErrorCount(0), YawCorrectionActivated(false), YawCorrectionInProgress(false), 
 	EnableYawCorrection(false)
 {
+   // Publish before attaching: once the handler is installed, the device
+   // thread may be publishing too, and the sequence lock allows one writer.
+   MagCalibrationMatrix.SetIdentity();
+   publishState();
    if (sensor)
        AttachToSensor(sensor);
-   MagCalibrationMatrix.SetIdentity();
 }
 
 SensorFusion::~SensorFusion()
@@ -86,7 +91,42 @@ void SensorFusion::handleMessage(const MessageBodyFrame& msg)
 {
     if (msg.Type != Message_BodyFrame)
         return;
-  
+
+    updateOrientation(msg);
+    publishState();
+}
+
+void SensorFusion::handleMessages(const MessageBodyFrame* msgs, unsigned count,
+                                  MessageHandler* frameDelegate)
+{
+    unsigned updated = 0;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (msgs[i].Type == Message_BodyFrame)
+        {
+            updateOrientation(msgs[i]);
+            updated++;
+        }
+
+        // A delegate taking single frames gets each one right after it is fused,
+        // with the state as of that frame, as when frames arrived one at a time.
+        if (frameDelegate)
+        {
+            if (updated)
+                publishState();
+            updated = 0;
+            frameDelegate->OnMessage(msgs[i]);
+        }
+    }
+
+    // Readers only ever need the newest state.
+    if (updated)
+        publishState();
+}
+
+void SensorFusion::updateOrientation(const MessageBodyFrame& msg)
+{
     // Put the sensor readings into convenient local variables
     Vector3f angVel    = msg.RotationRate; 
     Vector3f rawAccel  = msg.Acceleration;
@@ -120,9 +160,12 @@ void SensorFusion::handleMessage(const MessageBodyFrame& msg)
     // Acceleration in the world frame (Q is current HMD orientation)
     Vector3f accWorld  = Q.Rotate(rawAccel);
 
-    // Keep track of time
+    // Keep track of time. Messages from the sensor carry the time their sample was
+    // taken; for ones passed in without it, the time of arrival is close enough.
     Stage++;
-    float currentTime  = Stage * DeltaT; // Assumes uniform time spacing
+    RunningTime += msg.TimeDelta;
+    SampleTime   = (msg.AbsoluteTimeSeconds > 0) ? msg.AbsoluteTimeSeconds : Timer::GetSeconds();
+    float currentTime  = (float)RunningTime;
 
     // Insert current sensor data into filter history
     FRawMag.AddElement(RawMag);
@@ -149,9 +192,6 @@ void SensorFusion::handleMessage(const MessageBodyFrame& msg)
     // so it is periodically normalized.
     if (Stage % 5000 == 0)
         Q.Normalize();
-    
-	// Maintain the uncorrected orientation for later use by predictive filtering
-	QUncorrected = Q;
 
     // Perform tilt correction using the accelerometer data. This enables 
     // drift errors in pitch and roll to be corrected. Note that yaw cannot be corrected
@@ -273,51 +313,87 @@ void SensorFusion::handleMessage(const MessageBodyFrame& msg)
 }
 
 
-        // This is a simple predictive filter based only on extrapolating the smoothed, current angular velocity.
-        // Note that both QP (the predicted future orientation) and Q (the current orientation) are both maintained.
-Quatf       SensorFusion::GetPredictedOrientation()
+void SensorFusion::publishState()
+{
+    UInt32 seq = PublishedSeq.Load_Acquire();
+    PublishedSeq.Store_Release(seq + 1);
+    WriteBarrier();
+
+    Published.Orientation            = Q;
+    Published.Acceleration           = A;
+    Published.AngularVelocity        = AngV;
+    Published.Magnetometer           = RawMag;
+    Published.FilteredMagnetometer   = FRawMag.Mean();
+    Published.CalibratedMagnetometer = CalMag;
+
+    Published.Time                    = SampleTime;
+    Published.FilteredAngularVelocity = FAngV.SavitzkyGolaySmooth8();
+    // The derivative filter works in per-sample steps
+    Published.AngularAcceleration     = (DeltaT > 0) ? FAngV.SavitzkyGolayDerivative12() / DeltaT
+                                                     : Vector3f();
+
+    WriteBarrier();
+    PublishedSeq.Store_Release(seq + 2);
+}
+
+SensorFusion::State SensorFusion::GetState() const
+{
+    State  state;
+    UInt32 seq;
+    do
+    {
+        seq = PublishedSeq.Load_Acquire();
+        ReadBarrier();
+        state = Published;
+        ReadBarrier();
+    } while ((seq & 1) || (seq != PublishedSeq.Load_Acquire()));
+    return state;
+}
+
+
+const float SensorFusion::MaxPredictionDT = 0.1f;
+
+// This is a simple predictive filter based on extrapolating the smoothed, current angular
+// velocity, optionally changing at the current angular acceleration. With acceleration,
+// the rotation uses the average velocity over the interval (its value at the midpoint).
+Quatf SensorFusion::predictOrientation(const State& state, float dt, bool useAcceleration)
+{
+    Vector3f angVelF = state.FilteredAngularVelocity;
+    if (useAcceleration)
+        angVelF += state.AngularAcceleration * (dt * 0.5f);
+
+    float angVelFL = angVelF.Length();
+    if (angVelFL > 0.001f)
+    {
+        Vector3f    rotAxisP      = angVelF / angVelFL;  
+        float       halfRotAngleP = angVelFL * dt * 0.5f;
+        float       sinaHRAP      = sin(halfRotAngleP);
+        Quatf       deltaQP(rotAxisP.x*sinaHRAP, rotAxisP.y*sinaHRAP,
+                            rotAxisP.z*sinaHRAP, cos(halfRotAngleP));
+        return state.Orientation * deltaQP;
+    }
+    return state.Orientation;
+}
+
+Quatf SensorFusion::GetPredictedOrientation() const
 {		
-	Lock::Locker lockScope(Handler.GetHandlerLock());
-	Quatf qP = QUncorrected;
-	if (EnablePrediction) {
-#if 1
-	    Vector3f angVelF  = FAngV.SavitzkyGolaySmooth8();
-        float    angVelFL = angVelF.Length();
-            
-        if (angVelFL > 0.001f)
-        {
-            Vector3f    rotAxisP      = angVelF / angVelFL;  
-            float       halfRotAngleP = angVelFL * PredictionDT * 0.5f;
-            float       sinaHRAP      = sin(halfRotAngleP);
-		    Quatf       deltaQP(rotAxisP.x*sinaHRAP, rotAxisP.y*sinaHRAP,
-                                rotAxisP.z*sinaHRAP, cos(halfRotAngleP));
-            qP = QUncorrected * deltaQP;
-        }
-#else
-        Quatd qpd = Quatd(Q.x,Q.y,Q.z,Q.w);
-        int predictionStages = (int)(PredictionDT / DeltaT);
-        Vector3f  aa = FAngV.SavitzkyGolayDerivative12();
-        Vector3d  aad     = Vector3d(aa.x,aa.y,aa.z);
-        Vector3f angVelF  = FAngV.SavitzkyGolaySmooth8();
-        Vector3d  avkd    = Vector3d(angVelF.x,angVelF.y,angVelF.z);
-        for (int i = 0; i < predictionStages; i++)
-        {
-            double angVelLengthd = avkd.Length();
-            Vector3d rotAxisd      = avkd / angVelLengthd;
-            double halfRotAngled = angVelLengthd * DeltaT * 0.5;
-            double sinHRAd       = sin(halfRotAngled);
-            Quatd  deltaQd       = Quatd(rotAxisd.x*sinHRAd, rotAxisd.y*sinHRAd, rotAxisd.z*sinHRAd,
-                                         cos(halfRotAngled));
-            qpd =  qpd * deltaQd;
-            // Update vel
-            avkd += aad;
-        }
-        qP = Quatf((float)qpd.x,(float)qpd.y,(float)qpd.z,(float)qpd.w);
-#endif
-	}
-    return qP;
+    State state = GetState();
+    if (!EnablePrediction)
+        return state.Orientation;
+    return predictOrientation(state, PredictionDT, EnablePredictAcceleration);
 }    
 
+Quatf SensorFusion::GetPredictedOrientation(double absoluteTime) const
+{
+    State state = GetState();
+    float dt    = (float)(absoluteTime - state.Time);
+    if (dt <= 0)
+        return state.Orientation;
+    if (dt > MaxPredictionDT)
+        dt = MaxPredictionDT;
+    return predictOrientation(state, dt, EnablePredictAcceleration);
+}
+
 
 Vector3f    SensorFusion::GetCalibratedMagValue(const Vector3f& rawMag) const
 {
@@ -362,15 +438,32 @@ SensorFusion::BodyFrameHandler::~BodyFrameHandler()
 
 void SensorFusion::BodyFrameHandler::OnMessage(const Message& msg)
 {
+    MessageHandler* delegate = pFusion->pDelegate;
+
+    if (msg.Type == Message_BodyFrameBatch)
+    {
+        const MessageBodyFrameBatch& batch = static_cast<const MessageBodyFrameBatch&>(msg);
+
+        // The delegate sees frames as if it were the sensor's own handler.
+        MessageHandler* frameDelegate =
+            (delegate && delegate->SupportsMessageType(Message_BodyFrame)) ? delegate : 0;
+        pFusion->handleMessages(batch.Frames, batch.FrameCount, frameDelegate);
+
+        if (delegate && delegate->SupportsMessageType(Message_BodyFrameBatch))
+            delegate->OnMessage(msg);
+        return;
+    }
+
     if (msg.Type == Message_BodyFrame)
         pFusion->handleMessage(static_cast<const MessageBodyFrame&>(msg));
-    if (pFusion->pDelegate)
-        pFusion->pDelegate->OnMessage(msg);
+    if (delegate)
+        delegate->OnMessage(msg);
 }
 
+// Sensor frames arrive in batches, one per report.
 bool SensorFusion::BodyFrameHandler::SupportsMessageType(MessageType type) const
 {
-    return (type == Message_BodyFrame);
+    return (type == Message_BodyFrameBatch);
 }
 
 
@@ -33,11 +33,33 @@ namespace OVR {
 // The class can operate in two ways:
 //  - By user manually passing MessageBodyFrame messages to the OnMessage() function. 
 //  - By attaching SensorFusion to a SensorDevice, in which case it will
-//    automatically handle notifications from that device.
+//    automatically handle notifications from that device. It takes them as one
+//    MessageBodyFrameBatch per sensor report.
+//
+// The outputs (orientation, acceleration, angular velocity and magnetometer) are
+// published as a State snapshot after each message or batch. The Get functions for them,
+// and prediction, read the snapshot without taking the handler lock, so a render
+// thread never waits on the sensor thread.
 
 class SensorFusion : public NewOverrideBase
 {
 public:
+    // Fusion outputs as of the last processed message.
+    struct State
+    {
+        Quatf       Orientation;
+        Vector3f    Acceleration;       // m/s^2
+        Vector3f    AngularVelocity;    // rad/s
+        Vector3f    Magnetometer;       // Gauss, uncalibrated
+        Vector3f    FilteredMagnetometer;
+        Vector3f    CalibratedMagnetometer;
+
+        // Prediction inputs
+        double      Time;                       // When the sample was taken, Timer::GetSeconds() clock
+        Vector3f    FilteredAngularVelocity;    // rad/s, smoothed over the last 8 samples
+        Vector3f    AngularAcceleration;        // rad/s^2, from the last 12 samples
+    };
+
     SensorFusion(SensorDevice* sensor = 0);
     ~SensorFusion();
     
@@ -106,47 +128,59 @@ public:
         handleMessage(msg);
     }
 
+    // Same for all the frames of a sensor report at once; the outputs are
+    // published once, after the last frame.
+    void        OnMessage(const MessageBodyFrameBatch& msg)
+    {
+        OVR_ASSERT(!IsAttachedToSensor());
+        handleMessages(msg.Frames, msg.FrameCount);
+    }
+
+    // Obtain all outputs together, consistent with each other. Never blocks.
+    State       GetState() const;
+
     // Obtain the current accumulated orientation.
     Quatf       GetOrientation() const
     {
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return Q;
+        return GetState().Orientation;
     }    
 
-    // Use a predictive filter to estimate the future orientation
-    Quatf       GetPredictedOrientation();
+    // Use a predictive filter to estimate the orientation PredictionDT after the last
+    // sample. Returns the current orientation if prediction is disabled.
+    Quatf       GetPredictedOrientation() const;
+
+    // Estimate the orientation at absoluteTime, on the Timer::GetSeconds() clock (such
+    // as the expected photon time of the frame being rendered), from the time of the
+    // last sample. Predicts regardless of IsPredictionEnabled; times before the last
+    // sample return it unchanged, and more than MaxPredictionDT ahead are clamped.
+    Quatf       GetPredictedOrientation(double absoluteTime) const;
 
     // Obtain the last absolute acceleration reading, in m/s^2.
     Vector3f    GetAcceleration() const
     {
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return A;
+        return GetState().Acceleration;
     }
     
     // Obtain the last angular velocity reading, in rad/s.
     Vector3f    GetAngularVelocity() const
     {
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return AngV;
+        return GetState().AngularVelocity;
     }
     // Obtain the last magnetometer reading, in Gauss
     Vector3f    GetMagnetometer() const
     {
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return RawMag;
+        return GetState().Magnetometer;
     }
     // Obtain the filtered magnetometer reading, in Gauss
     Vector3f    GetFilteredMagnetometer() const
     {
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return FRawMag.Mean();
+        return GetState().FilteredMagnetometer;
     }
     // Obtain the calibrated magnetometer reading (direction and field strength)
     Vector3f    GetCalibratedMagnetometer() const
     {
         OVR_ASSERT(MagCalibrated);
-        Lock::Locker lockScope(Handler.GetHandlerLock());
-        return CalMag;
+        return GetState().CalibratedMagnetometer;
     }
 
     Vector3f    GetCalibratedMagValue(const Vector3f& rawMag) const;
@@ -168,9 +202,10 @@ public:
     {
         Lock::Locker lockScope(Handler.GetHandlerLock());
         Q  = Quatf();
-        QUncorrected = Quatf();
 
         Stage = 0;
+        RunningTime = 0;
+        publishState();
     }
 
     // Configuration
@@ -185,6 +220,9 @@ public:
     float       GetYawMultiplier() const  { return YawMult; }
     void        SetYawMultiplier(float y) { YawMult = y; }
 
+    // The delegate is passed the sensor's messages after fusion has processed
+    // them: each MessageBodyFrame right after it is fused, and a
+    // MessageBodyFrameBatch after all of its frames, if it supports those types.
     void        SetDelegateMessageHandler(MessageHandler* handler)
     { pDelegate = handler; }
 
@@ -197,6 +235,14 @@ public:
 	void		SetPredictionEnabled(bool enable = true)    { EnablePrediction = enable; }    
 	bool		IsPredictionEnabled()                       { return EnablePrediction; }
 
+    // Include angular acceleration in prediction (off by default). It helps when the head
+    // is speeding up or slowing down, at the cost of amplifying gyro noise.
+    void        SetPredictAccelerationEnabled(bool enable = true) { EnablePredictAcceleration = enable; }
+    bool        IsPredictAccelerationEnabled() const              { return EnablePredictAcceleration; }
+
+    // Longest interval GetPredictedOrientation(absoluteTime) extrapolates over, in seconds.
+    static const float MaxPredictionDT;
+
     // Methods for magnetometer calibration
     static float       AngleDifference(float theta1, float theta2);
     static Vector3f    CalculateSphereCenter(Vector3f p1, Vector3f p2,
@@ -208,6 +254,19 @@ private:
 
     // Internal handler for messages; bypasses error checking.
     void handleMessage(const MessageBodyFrame& msg);
+    // Publishes once after the last frame, or after every frame when frameDelegate
+    // is given, which is then passed each frame once it is fused.
+    void handleMessages(const MessageBodyFrame* msgs, unsigned count,
+                        MessageHandler* frameDelegate = 0);
+
+    // Integrates one sample; handleMessage(s) publish the result.
+    void updateOrientation(const MessageBodyFrame& msg);
+
+    // Copies the outputs into Published. Called by the one thread updating them.
+    void publishState();
+
+    // Rotates state.Orientation by the filtered angular velocity over dt seconds.
+    static Quatf predictOrientation(const State& state, float dt, bool useAcceleration);
 
     class BodyFrameHandler : public MessageHandler
     {
@@ -221,13 +280,14 @@ private:
     };   
 
     Quatf             Q;
-	Quatf			  QUncorrected;
     Vector3f          A;    
     Vector3f          AngV;
     Vector3f          CalMag;
     Vector3f          RawMag;
     unsigned int      Stage;
 	float             DeltaT;
+    double            RunningTime;      // Sum of message TimeDeltas since Reset
+    double            SampleTime;       // Absolute time of the last sample
     BodyFrameHandler  Handler;
     MessageHandler*   pDelegate;
     float             Gain;
@@ -236,6 +296,7 @@ private:
 
     bool              EnablePrediction;
     float             PredictionDT;
+    bool              EnablePredictAcceleration;
 
     SensorFilter      FRawMag;
     SensorFilter      FAccW;
@@ -260,6 +321,10 @@ private:
     bool              YawCorrectionInProgress;
 	bool			  YawCorrectionActivated;
 
+    // Sequence lock for Published: odd while publishState is writing it.
+    // Readers copy Published and retry if the count was odd or changed.
+    AtomicInt<UInt32> PublishedSeq;
+    State             Published;
 };
 
 
@@ -92,15 +92,18 @@ struct TrackerSample
 };
 
 
+// TrackerSensors decodes the report header; samples stay packed in the report
+// buffer until GetSample unpacks the one being converted, so a report is read
+// once, straight from the HID device's buffer.
 struct TrackerSensors
 {
+    const UByte* Buffer;
+
     UByte	SampleCount;
     UInt16	Timestamp;
     UInt16	LastCommandID;
     SInt16	Temperature;
 
-    TrackerSample Samples[3];
-
     SInt16	MagX, MagY, MagZ;
 
     TrackerMessageType Decode(const UByte* buffer, int size)
@@ -108,6 +111,7 @@ struct TrackerSensors
         if (size < 62)
             return TrackerMessage_SizeError;
 
+        Buffer          = buffer;
         SampleCount		= buffer[1];
         Timestamp		= DecodeUInt16(buffer + 2);
         LastCommandID	= DecodeUInt16(buffer + 4);
@@ -116,21 +120,20 @@ struct TrackerSensors
         //if (SampleCount > 2)        
         //    OVR_DEBUG_LOG_TEXT(("TackerSensor::Decode SampleCount=%d\n", SampleCount));        
 
-        // Only unpack as many samples as there actually are
-        UByte iterationCount = (SampleCount > 2) ? 3 : SampleCount;
-
-        for (UByte i = 0; i < iterationCount; i++)
-        {
-            UnpackSensor(buffer + 8 + 16 * i,  &Samples[i].AccelX, &Samples[i].AccelY, &Samples[i].AccelZ);
-            UnpackSensor(buffer + 16 + 16 * i, &Samples[i].GyroX,  &Samples[i].GyroY,  &Samples[i].GyroZ);
-        }
-
         MagX = DecodeSInt16(buffer + 56);
         MagY = DecodeSInt16(buffer + 58);
         MagZ = DecodeSInt16(buffer + 60);
 
         return TrackerMessage_Sensors;
     }
+
+    // There are at most three samples, whatever SampleCount says.
+    void GetSample(UByte i, TrackerSample* sample) const
+    {
+        OVR_ASSERT(i < 3);
+        UnpackSensor(Buffer + 8 + 16 * i,  &sample->AccelX, &sample->AccelY, &sample->AccelZ);
+        UnpackSensor(Buffer + 16 + 16 * i, &sample->GyroX,  &sample->GyroY,  &sample->GyroZ);
+    }
 };
 
 struct TrackerMessage
@@ -141,8 +144,6 @@ struct TrackerMessage
 
 bool DecodeTrackerMessage(TrackerMessage* message, UByte* buffer, int size)
 {
-    memset(message, 0, sizeof(TrackerMessage));
-
     if (size < 4)
     {
         message->Type = TrackerMessage_SizeError;
@@ -486,6 +487,7 @@ SensorDeviceImpl::SensorDeviceImpl(SensorDeviceCreateDesc* createDesc)
       Coordinates(SensorDevice::Coord_Sensor),
       HWCoordinates(SensorDevice::Coord_HMD), // HW reports HMD coordinates by default.
       NextKeepAliveTicks(0),
+      BodyFrames(this),
       MaxValidRange(SensorRangeImpl::GetMaxSensorRange())
 {
     SequenceValid  = false;
@@ -741,10 +743,9 @@ void SensorDeviceImpl::SetMessageHandler(MessageHandler* handler)
 // We need to convert it to the following RHS coordinate system:
 // X right, Y Up, Z Back (out of screen)
 //
-Vector3f AccelFromBodyFrameUpdate(const TrackerSensors& update, UByte sampleNumber,
+Vector3f AccelFromBodyFrameUpdate(const TrackerSample& sample,
                                   bool convertHMDToSensor = false)
 {
-    const TrackerSample& sample = update.Samples[sampleNumber];
     float                ax = (float)sample.AccelX;
     float                ay = (float)sample.AccelY;
     float                az = (float)sample.AccelZ;
@@ -771,10 +772,9 @@ Vector3f MagFromBodyFrameUpdate(const TrackerSensors& update,
                     -(float)update.MagZ) * 0.0001f;
 }
 
-Vector3f EulerFromBodyFrameUpdate(const TrackerSensors& update, UByte sampleNumber,
+Vector3f EulerFromBodyFrameUpdate(const TrackerSample& sample,
                                   bool convertHMDToSensor = false)
 {
-    const TrackerSample& sample = update.Samples[sampleNumber];
     float                gx = (float)sample.GyroX;
     float                gy = (float)sample.GyroY;
     float                gz = (float)sample.GyroZ;
@@ -791,11 +791,19 @@ void SensorDeviceImpl::onTrackerMessage(TrackerMessage* message)
     
     const float     timeUnit   = (1.0f / 1000.f);
     TrackerSensors& s = message->Sensors;
+
+    // The report arrives just after its last sample was taken; the samples
+    // before it are one timeUnit apart.
+    const double    reportTime = Timer::GetSeconds();
     
 
     // Call OnMessage() within a lock to avoid conflicts with handlers.
-    Lock::Locker scopeLock(HandlerRef.GetLock());
+    MessageHandlerRef::Locker scopeLock(HandlerRef);
+    MessageHandler*           handler = HandlerRef.GetHandler();
 
+    // Frames are decoded straight into the batch, which also serves as their
+    // storage when they are delivered one at a time.
+    BodyFrames.FrameCount = 0;
 
     if (SequenceValid)
     {
@@ -809,16 +817,15 @@ void SensorDeviceImpl::onTrackerMessage(TrackerMessage* message)
         // If we missed a small number of samples, replicate the last sample.
         if ((timestampDelta > LastSampleCount) && (timestampDelta <= 254))
         {
-            if (HandlerRef.GetHandler())
+            if (handler)
             {
-                MessageBodyFrame sensors(this);
+                MessageBodyFrame& sensors = BodyFrames.Frames[BodyFrames.FrameCount++];
                 sensors.TimeDelta     = (timestampDelta - LastSampleCount) * timeUnit;
+                sensors.AbsoluteTimeSeconds = reportTime - s.SampleCount * timeUnit;
                 sensors.Acceleration  = LastAcceleration;
                 sensors.RotationRate  = LastRotationRate;
                 sensors.MagneticField = LastMagneticField;
                 sensors.Temperature   = LastTemperature;
-
-                HandlerRef.GetHandler()->OnMessage(sensors);
             }
         }
     }
@@ -834,44 +841,56 @@ void SensorDeviceImpl::onTrackerMessage(TrackerMessage* message)
     LastSampleCount = s.SampleCount;
     LastTimestamp   = s.Timestamp;
 
-    bool convertHMDToSensor = (Coordinates == Coord_Sensor) && (HWCoordinates == Coord_HMD);
+    bool          convertHMDToSensor = (Coordinates == Coord_Sensor) && (HWCoordinates == Coord_HMD);
+    UByte         iterations         = (s.SampleCount > 3) ? 3 : s.SampleCount;
+    TrackerSample sample;
 
-    if (HandlerRef.GetHandler())
+    if (handler)
     {
-        MessageBodyFrame sensors(this);                
-        UByte            iterations = s.SampleCount;
+        Vector3f magneticField = MagFromBodyFrameUpdate(s, convertHMDToSensor);
+        float    temperature   = s.Temperature * 0.01f;
 
-        if (s.SampleCount > 3)
+        for (UByte i = 0; i < iterations; i++)
         {
-            iterations        = 3;
-            sensors.TimeDelta = (s.SampleCount - 2) * timeUnit;
+            MessageBodyFrame& sensors = BodyFrames.Frames[BodyFrames.FrameCount++];
+
+            // With more than three ticks per report the first sample stands for
+            // all the older ones; TimeDelta for the last two sample is always fixed.
+            sensors.TimeDelta = ((i == 0) && (s.SampleCount > 3)) ?
+                                (s.SampleCount - 2) * timeUnit : timeUnit;
+
+            s.GetSample(i, &sample);
+            sensors.Acceleration = AccelFromBodyFrameUpdate(sample, convertHMDToSensor);
+            sensors.RotationRate = EulerFromBodyFrameUpdate(sample, convertHMDToSensor);
+            sensors.MagneticField= magneticField;
+            sensors.Temperature  = temperature;
+            sensors.AbsoluteTimeSeconds = reportTime - (iterations - 1 - i) * timeUnit;
         }
-        else
+
+        if (iterations)
         {
-            sensors.TimeDelta = timeUnit;
+            const MessageBodyFrame& last = BodyFrames.Frames[BodyFrames.FrameCount - 1];
+            LastAcceleration = last.Acceleration;
+            LastRotationRate = last.RotationRate;
+            LastMagneticField= last.MagneticField;
+            LastTemperature  = last.Temperature;
         }
 
-        for (UByte i = 0; i < iterations; i++)
-        {            
-            sensors.Acceleration = AccelFromBodyFrameUpdate(s, i, convertHMDToSensor);
-            sensors.RotationRate = EulerFromBodyFrameUpdate(s, i, convertHMDToSensor);
-            sensors.MagneticField= MagFromBodyFrameUpdate(s, convertHMDToSensor);
-            sensors.Temperature  = s.Temperature * 0.01f;
-            HandlerRef.GetHandler()->OnMessage(sensors);
-            // TimeDelta for the last two sample is always fixed.
-            sensors.TimeDelta = timeUnit;
+        if (handler->SupportsMessageType(Message_BodyFrame))
+        {
+            for (unsigned i = 0; i < BodyFrames.FrameCount; i++)
+                handler->OnMessage(BodyFrames.Frames[i]);
+        }
+        if ((BodyFrames.FrameCount > 0) && handler->SupportsMessageType(Message_BodyFrameBatch))
+        {
+            handler->OnMessage(BodyFrames);
         }
-
-        LastAcceleration = sensors.Acceleration;
-        LastRotationRate = sensors.RotationRate;
-        LastMagneticField= sensors.MagneticField;
-        LastTemperature  = sensors.Temperature;
     }
-    else
+    else if (iterations)
     {
-        UByte i = (s.SampleCount > 3) ? 2 : (s.SampleCount - 1);
-        LastAcceleration  = AccelFromBodyFrameUpdate(s, i, convertHMDToSensor);
-        LastRotationRate  = EulerFromBodyFrameUpdate(s, i, convertHMDToSensor);
+        s.GetSample(iterations - 1, &sample);
+        LastAcceleration  = AccelFromBodyFrameUpdate(sample, convertHMDToSensor);
+        LastRotationRate  = EulerFromBodyFrameUpdate(sample, convertHMDToSensor);
         LastMagneticField = MagFromBodyFrameUpdate(s, convertHMDToSensor);
         LastTemperature   = s.Temperature * 0.01f;
     }
@@ -195,6 +195,9 @@ protected:
     Vector3f    LastRotationRate;
     Vector3f    LastMagneticField;
 
+    // Reused for every report, so decoding and dispatch don't allocate.
+    MessageBodyFrameBatch BodyFrames;
+
     // Current sensor range obtained from device. 
     SensorRange MaxValidRange;
     SensorRange CurrentRange;
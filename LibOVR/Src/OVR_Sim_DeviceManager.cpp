@@ -0,0 +1,281 @@
+/************************************************************************************
+
+Filename    :   OVR_Sim_DeviceManager.cpp
+Content     :   DeviceManager running on simulated HID devices.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_Sim_DeviceManager.h"
+
+// Sensor & LatencyTest Factories
+#include "OVR_LatencyTestImpl.h"
+#include "OVR_SensorImpl.h"
+#include "OVR_Sim_HIDDevice.h"
+
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Log.h"
+
+
+namespace OVR { namespace Sim {
+
+//-------------------------------------------------------------------------------------
+// **** Sim::DeviceManager
+
+DeviceManager::DeviceManager()
+{
+    HidDeviceManager = *new HIDDeviceManager(this);
+}
+
+DeviceManager::~DeviceManager()
+{
+    // make sure Shutdown was called.
+    OVR_ASSERT(!pThread);
+}
+
+bool DeviceManager::Initialize(DeviceBase*)
+{
+    if (!DeviceManagerImpl::Initialize(0))
+        return false;
+
+    pThread = *new DeviceManagerThread();
+    if (!pThread || !pThread->Start())
+        return false;
+
+    pCreateDesc->pDevice = this;
+    LogText("OVR::Sim::DeviceManager - initialized.\n");
+    return true;
+}
+
+void DeviceManager::Shutdown()
+{
+    LogText("OVR::Sim::DeviceManager - shutting down.\n");
+
+    // Set Manager shutdown marker variable; this prevents
+    // any existing DeviceHandle objects from accessing device.
+    pCreateDesc->pLock->pManager = 0;
+
+    // Push for thread shutdown *WITH NO WAIT*; see Win32::DeviceManager::Shutdown.
+    pThread->PushExitCommand(false);
+    pThread.Clear();
+
+    DeviceManagerImpl::Shutdown();
+}
+
+ThreadCommandQueue* DeviceManager::GetThreadQueue()
+{
+    return pThread;
+}
+
+ThreadId DeviceManager::GetThreadId() const
+{
+    return pThread->GetThreadId();
+}
+
+bool DeviceManager::GetDeviceInfo(DeviceInfo* info) const
+{
+    if ((info->InfoClassType != Device_Manager) &&
+        (info->InfoClassType != Device_None))
+        return false;
+
+    info->Type    = Device_Manager;
+    info->Version = 0;
+    OVR_strcpy(info->ProductName, DeviceInfo::MaxNameLength, "DeviceManager");
+    OVR_strcpy(info->Manufacturer,DeviceInfo::MaxNameLength, "Oculus VR, Inc.");
+    return true;
+}
+
+DeviceEnumerator<> DeviceManager::EnumerateDevicesEx(const DeviceEnumerationArgs& args)
+{
+    if (GetThreadId() != OVR::GetCurrentThreadId())
+    {
+        pThread->PushCall((DeviceManagerImpl*)this,
+            &DeviceManager::EnumerateAllFactoryDevices, true);
+    }
+    else
+        DeviceManager::EnumerateAllFactoryDevices();
+
+    return DeviceManagerImpl::EnumerateDevicesEx(args);
+}
+
+String DeviceManager::AddDevice(const HIDDeviceConfig& config)
+{
+    String path;
+
+    if (GetThreadId() != OVR::GetCurrentThreadId())
+        pThread->PushCallAndWaitResult(this, &DeviceManager::addDevice_MgrThread, &path, &config);
+    else
+        path = addDevice_MgrThread(&config);
+
+    return path;
+}
+
+bool DeviceManager::RemoveDevice(const String& path)
+{
+    bool result = false;
+
+    if (GetThreadId() != OVR::GetCurrentThreadId())
+        pThread->PushCallAndWaitResult(this, &DeviceManager::removeDevice_MgrThread, &result, &path);
+    else
+        result = removeDevice_MgrThread(&path);
+
+    return result;
+}
+
+String DeviceManager::addDevice_MgrThread(const HIDDeviceConfig* config)
+{
+    return static_cast<HIDDeviceManager*>(HidDeviceManager.GetPtr())->Plug(*config);
+}
+
+bool DeviceManager::removeDevice_MgrThread(const String* path)
+{
+    return static_cast<HIDDeviceManager*>(HidDeviceManager.GetPtr())->Unplug(*path);
+}
+
+// Creates a new simulated DeviceManager, with no devices plugged in.
+DeviceManager* DeviceManager::Create()
+{
+    if (!System::IsInitialized())
+    {
+        // Use custom message, since Log is not yet installed.
+        OVR_DEBUG_STATEMENT(Log::GetDefaultLog()->
+            LogMessage(Log_Debug, "Sim::DeviceManager::Create failed - OVR::System not initialized"); );
+        return 0;
+    }
+
+    Ptr<Sim::DeviceManager> manager = *new Sim::DeviceManager;
+
+    if (manager)
+    {
+        if (manager->Initialize(0))
+        {
+            // HMDs are only known through the tracker's DisplayInfo.
+            manager->AddFactory(&SensorDeviceFactory::Instance);
+            manager->AddFactory(&LatencyTestDeviceFactory::Instance);
+
+            manager->AddRef();
+        }
+        else
+        {
+            manager.Clear();
+        }
+    }
+
+    return manager.GetPtr();
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** DeviceManager Thread
+
+DeviceManagerThread::DeviceManagerThread()
+    : Thread(ThreadStackSize)
+{
+}
+
+DeviceManagerThread::~DeviceManagerThread()
+{
+}
+
+int DeviceManagerThread::Run()
+{
+    ThreadCommand::PopBuffer command;
+
+    SetThreadName("OVR::Sim::DeviceManagerThread");
+    LogText("OVR::Sim::DeviceManagerThread - running (ThreadId=%p).\n", GetThreadId());
+
+    while(!IsExiting())
+    {
+        // PopCommand will reset event on empty queue.
+        if (PopCommand(&command))
+        {
+            command.Execute();
+        }
+        else
+        {
+            bool commandsPending = false;
+            while (!commandsPending)
+            {
+                unsigned waitMs = OVR_WAIT_INFINITE;
+
+                // Run the tick notifiers that are due and sleep until the next
+                // deadline, rounded up so as not to wake just short of it.
+                UInt64 waitMks = TicksNotifiers.RunDue(Timer::GetTicks(), &Notifier::OnTicks);
+                if (waitMks != ~UInt64(0))
+                {
+                    UInt64 waitAllowed = waitMks / Timer::MksPerMs + ((waitMks % Timer::MksPerMs) ? 1 : 0);
+                    waitMs = (waitAllowed >= OVR_WAIT_INFINITE) ? (OVR_WAIT_INFINITE - 1) : (unsigned)waitAllowed;
+                }
+
+                commandsPending = CommandEvent.Wait(waitMs);
+            }
+        }
+    }
+
+    LogText("OVR::Sim::DeviceManagerThread - exiting (ThreadId=%p).\n", GetThreadId());
+    return 0;
+}
+
+bool DeviceManagerThread::AddTicksNotifier(Notifier* notify)
+{
+    if (!TicksNotifiers.Contains(notify))
+        TicksNotifiers.Schedule(notify, 0);
+    return true;
+}
+
+bool DeviceManagerThread::RemoveTicksNotifier(Notifier* notify)
+{
+    return TicksNotifiers.Remove(notify);
+}
+
+bool DeviceManagerThread::ScheduleTicks(Notifier* notify, UInt64 ticksMks)
+{
+    if (!TicksNotifiers.Contains(notify))
+        return false;
+    TicksNotifiers.Schedule(notify, ticksMks);
+    return true;
+}
+
+bool DeviceManagerThread::AddMessageNotifier(Notifier* notify)
+{
+    MessageNotifiers.PushBack(notify);
+    return true;
+}
+
+bool DeviceManagerThread::RemoveMessageNotifier(Notifier* notify)
+{
+    for (UPInt i = 0; i < MessageNotifiers.GetSize(); i++)
+    {
+        if (MessageNotifiers[i] == notify)
+        {
+            MessageNotifiers.RemoveAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeviceManagerThread::OnDeviceMessage(Notifier::DeviceMessageType type, const String& devicePath)
+{
+    bool error = false;
+
+    for (UPInt i = 0; i < MessageNotifiers.GetSize(); i++)
+    {
+        if (MessageNotifiers[i] &&
+            MessageNotifiers[i]->OnDeviceMessage(type, devicePath, &error))
+        {
+            // The notifier belonged to a device with the specified device name so we're done.
+            return true;
+        }
+    }
+    return false;
+}
+
+}} // namespace OVR::Sim
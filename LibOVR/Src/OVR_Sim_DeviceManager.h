@@ -0,0 +1,147 @@
+/************************************************************************************
+
+Filename    :   OVR_Sim_DeviceManager.h
+Content     :   DeviceManager running on simulated HID devices.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#ifndef OVR_Sim_DeviceManager_h
+#define OVR_Sim_DeviceManager_h
+
+#include "OVR_DeviceImpl.h"
+#include "OVR_DeadlineQueue.h"
+
+#include "Kernel/OVR_Timer.h"
+
+
+namespace OVR { namespace Sim {
+
+class DeviceManagerThread;
+struct HIDDeviceConfig;
+
+//-------------------------------------------------------------------------------------
+// ***** Sim DeviceManager
+
+// DeviceManager whose HID devices are simulated by Sim::HIDDeviceManager, so that
+// the Sensor and LatencyTest devices, and DeviceManagerImpl itself, can be driven
+// without hardware. It starts with no devices; AddDevice plugs them in.
+// Works on any platform that has OVR threads.
+
+class DeviceManager : public DeviceManagerImpl
+{
+public:
+    DeviceManager();
+    ~DeviceManager();
+
+    // Creates a new simulated DeviceManager; OVR::System must be initialized.
+    static DeviceManager* Create();
+
+    // Initialize/Shutdown manager thread.
+    virtual bool Initialize(DeviceBase* parent);
+    virtual void Shutdown();
+
+    virtual ThreadCommandQueue* GetThreadQueue();
+    virtual ThreadId GetThreadId() const;
+
+    virtual DeviceEnumerator<> EnumerateDevicesEx(const DeviceEnumerationArgs& args);
+
+    virtual bool  GetDeviceInfo(DeviceInfo* info) const;
+
+    // Plugs in a simulated device and returns its path, or an empty string on
+    // failure. Listeners get Message_DeviceAdded as for a hot-plugged device.
+    String  AddDevice(const HIDDeviceConfig& config);
+    // Unplugs the device at path; an open device reports that it was removed.
+    bool    RemoveDevice(const String& path);
+
+    Ptr<DeviceManagerThread> pThread;
+
+private:
+    // Run on the manager thread.
+    String  addDevice_MgrThread(const HIDDeviceConfig* config);
+    bool    removeDevice_MgrThread(const String* path);
+};
+
+//-------------------------------------------------------------------------------------
+// ***** Device Manager Background Thread
+
+// There is nothing to wait on but commands and time, so the thread sleeps on an
+// Event until the next tick deadline.
+
+class DeviceManagerThread : public Thread, public ThreadCommandQueue
+{
+    friend class DeviceManager;
+    enum { ThreadStackSize = 32 * 1024 };
+public:
+    DeviceManagerThread();
+    ~DeviceManagerThread();
+
+    virtual int Run();
+
+    // ThreadCommandQueue notifications for CommandEvent handling.
+    virtual void OnPushNonEmpty_Locked() { CommandEvent.SetEvent(); }
+    virtual void OnPopEmpty_Locked()     { CommandEvent.ResetEvent(); }
+
+
+    // Notifier used for different updates (regular timing or messages).
+    class Notifier
+    {
+    public:
+        // Called once the notifier's tick deadline has passed.
+        // Returns the largest number of microseconds this function can
+        // wait till next call; that sets the next deadline.
+        virtual UInt64  OnTicks(UInt64 ticksMks)
+        { OVR_UNUSED1(ticksMks);  return Timer::MksPerSecond * 1000; }
+
+        enum DeviceMessageType
+        {
+            DeviceMessage_DeviceAdded     = 0,
+            DeviceMessage_DeviceRemoved   = 1,
+        };
+
+        // Called to notify device object.
+        virtual bool    OnDeviceMessage(DeviceMessageType messageType,
+                                        const String& devicePath,
+                                        bool* error)
+        { OVR_UNUSED3(messageType, devicePath, error); return false; }
+    };
+
+
+    // Add notifier that will be called at regular intervals. Its first
+    // OnTicks call happens on the next pass through the thread loop.
+    bool AddTicksNotifier(Notifier* notify);
+    bool RemoveTicksNotifier(Notifier* notify);
+
+    // Moves notifier's next OnTicks call to the absolute time ticksMks
+    // (Timer::GetTicks), e.g. 0 for as soon as possible.
+    // Returns 'false' if the notifier isn't registered.
+    bool ScheduleTicks(Notifier* notify, UInt64 ticksMks);
+
+    bool AddMessageNotifier(Notifier* notify);
+    bool RemoveMessageNotifier(Notifier* notify);
+
+    // Passes a hot-plug message to the message notifiers. Returns 'true' if one of
+    // them owns the device at devicePath.
+    bool OnDeviceMessage(Notifier::DeviceMessageType type, const String& devicePath);
+
+private:
+    // Set while thread commands are queued.
+    Event                   CommandEvent;
+
+    // Ticks notifiers - simulated devices and their handlers' keep-alive,
+    // ordered by when each wants its next OnTicks call.
+    DeadlineQueue<Notifier*> TicksNotifiers;
+
+    // Message notifiers.
+    Array<Notifier*>        MessageNotifiers;
+};
+
+}} // namespace Sim::OVR
+
+#endif // OVR_Sim_DeviceManager_h
@@ -0,0 +1,766 @@
+/************************************************************************************
+
+Filename    :   OVR_Sim_HIDDevice.cpp
+Content     :   Simulated HID devices: a tracker and a latency tester.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR_Sim_HIDDevice.h"
+#include "OVR_Sim_DeviceManager.h"
+#include "OVR_SensorImpl.h"
+
+#include "Kernel/OVR_SysFile.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Log.h"
+
+namespace OVR { namespace Sim {
+
+//-------------------------------------------------------------------------------------
+// Ids and report layouts the device classes expect; see OVR_SensorImpl.cpp and
+// OVR_LatencyTestImpl.cpp.
+
+enum {
+    Tracker_ProductId       = 0x0001,
+    LatencyTester_ProductId = 0x0101,
+
+    Tracker_SensorsReport   = 1,
+    Tracker_ConfigReport    = 2,
+    Tracker_RangeReport     = 4,
+    Tracker_KeepAliveReport = 8,
+    Tracker_DisplayInfoReport = 9,
+
+    LatencyTester_ColorDetectedReport = 2,
+    LatencyTester_TestStartedReport   = 3,
+    LatencyTester_ConfigReport        = 5,
+    LatencyTester_CalibrateReport     = 7,
+    LatencyTester_StartTestReport     = 8,
+    LatencyTester_DisplayReport       = 9,
+    LatencyTester_ReportSize          = 64
+};
+
+static void EncodeUInt16(UByte* buffer, UInt16 value)
+{
+    buffer[0] = UByte(value & 0xFF);
+    buffer[1] = UByte(value >> 8);
+}
+
+static void EncodeUInt32(UByte* buffer, UInt32 value)
+{
+    buffer[0] = UByte(value & 0xFF);
+    buffer[1] = UByte((value >> 8) & 0xFF);
+    buffer[2] = UByte((value >> 16) & 0xFF);
+    buffer[3] = UByte(value >> 24);
+}
+
+static void EncodeFloat(UByte* buffer, float value)
+{
+    union {
+        UInt32 U;
+        float  F;
+    };
+
+    F = value;
+    EncodeUInt32(buffer, U);
+}
+
+// Inverse of UnpackSensor: three 21-bit values in 8 bytes.
+static void PackSensor(UByte* buffer, SInt32 x, SInt32 y, SInt32 z)
+{
+    buffer[0] = UByte(x >> 13);
+    buffer[1] = UByte(x >> 5);
+    buffer[2] = UByte(((x << 3) & 0xF8) | ((y >> 18) & 0x07));
+    buffer[3] = UByte(y >> 10);
+    buffer[4] = UByte(y >> 2);
+    buffer[5] = UByte(((y << 6) & 0xC0) | ((z >> 15) & 0x3F));
+    buffer[6] = UByte(z >> 7);
+    buffer[7] = UByte((z << 1) & 0xFE);
+}
+
+static UInt32 NextRandom(UInt32* state)
+{
+    *state = *state * 1103515245 + 12345;
+    return (*state >> 16) & 0x7FFF;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** SyntheticMotion
+
+SyntheticMotion::SyntheticMotion(float yawRate, SInt32 noise, UInt32 seed)
+ : YawRate(yawRate), Noise(noise), Seed(seed), StartTicks(0)
+{
+}
+
+SInt32 SyntheticMotion::noise()
+{
+    if (Noise <= 0)
+        return 0;
+    return SInt32((SInt64(NextRandom(&Seed)) * (2 * Noise + 1)) >> 15) - Noise;
+}
+
+void SyntheticMotion::FillReport(UByte* report, UByte sampleCount, UInt16 timestamp,
+                                 UInt64 ticksMks)
+{
+    if (!StartTicks)
+        StartTicks = ticksMks;
+
+    memset(report, 0, ReportSize);
+    report[0] = Tracker_SensorsReport;
+    report[1] = sampleCount;
+    EncodeUInt16(report + 2, timestamp);
+    EncodeUInt16(report + 6, 2500);     // 25 C
+
+    UByte  samples  = (sampleCount > 3) ? 3 : sampleCount;
+    SInt32 yawRate  = SInt32(YawRate * 10000.0f);
+
+    for (UByte i = 0; i < samples; i++)
+    {
+        PackSensor(report + 8 + 16 * i,
+                   noise(), 98100 + noise(), noise());
+        PackSensor(report + 16 + 16 * i,
+                   noise(), yawRate + noise(), noise());
+    }
+
+    // A 0.2 gauss field pointing along -Z (and down), seen from a sensor that has
+    // turned by yaw about Y. The firmware swaps the Y and Z magnetometer fields.
+    float  yaw = YawRate * float(ticksMks - StartTicks) / Timer::MksPerSecond;
+    SInt16 mx  = SInt16(2000.0f * sinf(yaw)) + SInt16(noise());
+    SInt16 my  = SInt16(-4000 + noise());
+    SInt16 mz  = SInt16(-2000.0f * cosf(yaw)) + SInt16(noise());
+
+    EncodeUInt16(report + 56, UInt16(mx));
+    EncodeUInt16(report + 58, UInt16(mz));
+    EncodeUInt16(report + 60, UInt16(my));
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** ReplayCapture
+
+bool ReplayCapture::LoadFile(const String& path)
+{
+    SysFile file(path);
+    if (!file.IsValid())
+        return false;
+
+    int length = file.GetLength();
+    if (length < ReportSize)
+        return false;
+
+    Reports.Resize(length - length % ReportSize);
+    if (file.Read(&Reports[0], (int)Reports.GetSize()) != (int)Reports.GetSize())
+    {
+        Reports.Clear();
+        return false;
+    }
+
+    NextReport = 0;
+    return true;
+}
+
+void ReplayCapture::SetReports(const UByte* reports, UPInt reportCount)
+{
+    Reports.Resize(reportCount * ReportSize);
+    if (reportCount)
+        memcpy(&Reports[0], reports, reportCount * ReportSize);
+    NextReport = 0;
+}
+
+void ReplayCapture::FillReport(UByte* report, UByte sampleCount, UInt16 timestamp,
+                               UInt64 ticksMks)
+{
+    OVR_UNUSED2(sampleCount, ticksMks);
+
+    if (GetReportCount() == 0)
+    {
+        // Nothing to replay; send reports without samples.
+        memset(report, 0, ReportSize);
+        report[0] = Tracker_SensorsReport;
+        EncodeUInt16(report + 2, timestamp);
+        return;
+    }
+
+    memcpy(report, &Reports[NextReport * ReportSize], ReportSize);
+    if (++NextReport == GetReportCount())
+        NextReport = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** HIDDeviceConfig
+
+HIDDeviceConfig::HIDDeviceConfig(DeviceKind kind)
+ :  Kind(kind), ReportRateHz(0), JitterMks(0), DropRate(0.0f), Seed(1),
+    LatencyMks(50 * 1000)
+{
+    if (kind == Device_Tracker)
+    {
+        DisplayInfo.HResolution            = 1280;
+        DisplayInfo.VResolution            = 800;
+        DisplayInfo.HScreenSize            = 0.14976f;
+        DisplayInfo.VScreenSize            = 0.0936f;
+        DisplayInfo.VScreenCenter          = 0.0468f;
+        DisplayInfo.EyeToScreenDistance    = 0.041f;
+        DisplayInfo.LensSeparationDistance = 0.0635f;
+        DisplayInfo.DistortionK[0]         = 1.0f;
+        DisplayInfo.DistortionK[1]         = 0.22f;
+        DisplayInfo.DistortionK[2]         = 0.24f;
+        DisplayInfo.DistortionK[3]         = 0.0f;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** SimulatedDevice
+
+// The "hardware" side of a plugged in device: its identity and the feature report
+// state that HIDDevice handles opened on it share.
+
+class SimulatedDevice : public RefCountBase<SimulatedDevice>
+{
+public:
+    enum { MaxReportId = 16, MaxFeatureSize = 64 };
+
+    HIDDeviceConfig             Config;
+    HIDDeviceDesc               Desc;
+    Ptr<TrackerReportSource>    Source;
+
+    // The tracker stops reporting once this passes, until the next keep-alive.
+    UInt64                      KeepAliveTicks;
+
+    SimulatedDevice(const HIDDeviceConfig& config, const String& serial);
+
+    bool    GetFeature(UByte* data, UInt32 length) const;
+    bool    SetFeature(const UByte* data, UInt32 length);
+
+    // Time between tracker reports, in microseconds.
+    UInt64  GetReportInterval() const;
+
+private:
+    void    addFeature(const UByte* data, UInt32 length);
+
+    // Last value of each feature report the device has, by report id.
+    UByte   FeatureReports[MaxReportId][MaxFeatureSize];
+    UInt32  FeatureSizes[MaxReportId];
+};
+
+SimulatedDevice::SimulatedDevice(const HIDDeviceConfig& config, const String& serial)
+ :  Config(config), Source(config.Source), KeepAliveTicks(~UInt64(0))
+{
+    memset(FeatureReports, 0, sizeof(FeatureReports));
+    memset(FeatureSizes, 0, sizeof(FeatureSizes));
+
+    bool tracker = (config.Kind == HIDDeviceConfig::Device_Tracker);
+
+    Config.SerialNumber = serial;
+    Desc.VendorId       = Oculus_VendorId;
+    Desc.ProductId      = tracker ? Tracker_ProductId : LatencyTester_ProductId;
+    Desc.VersionNumber  = 0x0100;
+    Desc.Usage          = 0;
+    Desc.UsagePage      = 0;
+    Desc.Path           = String(tracker ? "sim://tracker/" : "sim://latencytester/") + serial;
+    Desc.Manufacturer   = "Oculus VR, Inc.";
+    Desc.Product        = tracker ? "Tracker DK" : "Oculus Latency Tester";
+    Desc.SerialNumber   = serial;
+
+    if (tracker)
+    {
+        if (!Source)
+            Source = *new SyntheticMotion();
+
+        // Calibrated, 500 Hz, 10 second keep-alive.
+        UByte sconfig[7] = { Tracker_ConfigReport, 0, 0, 0x0C, 1, 0, 0 };
+        EncodeUInt16(sconfig + 5, 10 * 1000);
+        addFeature(sconfig, sizeof(sconfig));
+
+        // 4 g, 500 deg/s, 1.3 gauss.
+        UByte range[8] = { Tracker_RangeReport, 0, 0, 4, 0, 0, 0, 0 };
+        EncodeUInt16(range + 4, 500);
+        EncodeUInt16(range + 6, 1300);
+        addFeature(range, sizeof(range));
+
+        UByte keepAlive[5] = { Tracker_KeepAliveReport, 0, 0, 0, 0 };
+        EncodeUInt16(keepAlive + 3, 10 * 1000);
+        addFeature(keepAlive, sizeof(keepAlive));
+
+        const HMDInfo& hmd = config.DisplayInfo;
+        UByte displayInfo[SensorDisplayInfoImpl::PacketSize];
+        memset(displayInfo, 0, sizeof(displayInfo));
+        displayInfo[0] = Tracker_DisplayInfoReport;
+        if (hmd.HResolution)
+        {
+            displayInfo[3] = SensorDisplayInfoImpl::Base_Distortion;
+            EncodeUInt16(displayInfo + 4,  UInt16(hmd.HResolution));
+            EncodeUInt16(displayInfo + 6,  UInt16(hmd.VResolution));
+            EncodeUInt32(displayInfo + 8,  UInt32(hmd.HScreenSize * 1000000.f + 0.5f));
+            EncodeUInt32(displayInfo + 12, UInt32(hmd.VScreenSize * 1000000.f + 0.5f));
+            EncodeUInt32(displayInfo + 16, UInt32(hmd.VScreenCenter * 1000000.f + 0.5f));
+            EncodeUInt32(displayInfo + 20, UInt32(hmd.LensSeparationDistance * 1000000.f + 0.5f));
+            EncodeUInt32(displayInfo + 24, UInt32(hmd.EyeToScreenDistance * 1000000.f + 0.5f));
+            EncodeUInt32(displayInfo + 28, UInt32(hmd.EyeToScreenDistance * 1000000.f + 0.5f));
+            for (int i = 0; i < 4; i++)
+                EncodeFloat(displayInfo + 32 + 4 * i, hmd.DistortionK[i]);
+        }
+        addFeature(displayInfo, sizeof(displayInfo));
+    }
+    else
+    {
+        // Samples off, mid-grey threshold.
+        UByte lconfig[5] = { LatencyTester_ConfigReport, 0, 128, 128, 128 };
+        addFeature(lconfig, sizeof(lconfig));
+
+        UByte calibrate[4] = { LatencyTester_CalibrateReport, 0, 0, 0 };
+        addFeature(calibrate, sizeof(calibrate));
+
+        UByte startTest[6] = { LatencyTester_StartTestReport, 0, 0, 0, 0, 0 };
+        addFeature(startTest, sizeof(startTest));
+
+        UByte display[6] = { LatencyTester_DisplayReport, 0, 0, 0, 0, 0 };
+        addFeature(display, sizeof(display));
+    }
+}
+
+void SimulatedDevice::addFeature(const UByte* data, UInt32 length)
+{
+    OVR_ASSERT(data[0] < MaxReportId && length <= MaxFeatureSize);
+    memcpy(FeatureReports[data[0]], data, length);
+    FeatureSizes[data[0]] = length;
+}
+
+bool SimulatedDevice::GetFeature(UByte* data, UInt32 length) const
+{
+    if (!length || data[0] >= MaxReportId || !FeatureSizes[data[0]])
+        return false;
+
+    UByte  id   = data[0];
+    UInt32 size = (length < FeatureSizes[id]) ? length : FeatureSizes[id];
+    memcpy(data, FeatureReports[id], size);
+    if (length > size)
+        memset(data + size, 0, length - size);
+    return true;
+}
+
+bool SimulatedDevice::SetFeature(const UByte* data, UInt32 length)
+{
+    if (!length || data[0] >= MaxReportId || !FeatureSizes[data[0]])
+        return false;
+
+    UByte  id   = data[0];
+    UInt32 size = (length < FeatureSizes[id]) ? length : FeatureSizes[id];
+    memcpy(FeatureReports[id], data, size);
+
+    if ((Config.Kind == HIDDeviceConfig::Device_Tracker) && (id == Tracker_KeepAliveReport))
+    {
+        UInt16 intervalMs = FeatureReports[id][3] | (UInt16(FeatureReports[id][4]) << 8);
+        KeepAliveTicks = intervalMs ? (Timer::GetTicks() + intervalMs * Timer::MksPerMs) :
+                                      ~UInt64(0);
+    }
+    return true;
+}
+
+UInt64 SimulatedDevice::GetReportInterval() const
+{
+    if (Config.ReportRateHz)
+    {
+        UInt64 interval = Timer::MksPerSecond / Config.ReportRateHz;
+        return interval ? interval : 1;
+    }
+
+    // PacketInterval of the Config report counts in 1 ms sample periods.
+    return (UInt64(FeatureReports[Tracker_ConfigReport][4]) + 1) * Timer::MksPerMs;
+}
+
+
+//-------------------------------------------------------------------------------------
+// **** Sim::HIDDeviceManager
+
+HIDDeviceManager::HIDDeviceManager(DeviceManager* manager)
+ : Manager(manager), NextSerial(1)
+{
+}
+
+HIDDeviceManager::~HIDDeviceManager()
+{
+    for (UPInt i = 0; i < Devices.GetSize(); i++)
+        Devices[i]->Release();
+}
+
+SimulatedDevice* HIDDeviceManager::findDevice(const String& path) const
+{
+    for (UPInt i = 0; i < Devices.GetSize(); i++)
+    {
+        if (Devices[i]->Desc.Path.CompareNoCase(path) == 0)
+            return Devices[i];
+    }
+    return 0;
+}
+
+bool HIDDeviceManager::Enumerate(HIDEnumerateVisitor* enumVisitor)
+{
+    for (UPInt i = 0; i < Devices.GetSize(); i++)
+    {
+        SimulatedDevice*     simDevice = Devices[i];
+        const HIDDeviceDesc& devDesc   = simDevice->Desc;
+
+        if (!enumVisitor->MatchVendorProduct(devDesc.VendorId, devDesc.ProductId))
+            continue;
+
+        // As with hardware, don't read feature reports behind the back of
+        // an open device; it is still there, which is all we need to say.
+        Ptr<DeviceCreateDesc> existingDevice = Manager ? Manager->FindDevice(devDesc.Path) : 0;
+        if (existingDevice && existingDevice->pDevice)
+        {
+            existingDevice->Enumerated = true;
+            continue;
+        }
+
+        // Construct minimal device that the visitor callback can get feature reports from.
+        Sim::HIDDevice device(this, simDevice, true);
+        enumVisitor->Visit(device, devDesc);
+    }
+
+    return true;
+}
+
+bool HIDDeviceManager::GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const
+{
+    SimulatedDevice* simDevice = findDevice(path);
+    if (!simDevice)
+        return false;
+
+    *pdevDesc = simDevice->Desc;
+    return true;
+}
+
+OVR::HIDDevice* HIDDeviceManager::Open(const String& path)
+{
+    SimulatedDevice* simDevice = findDevice(path);
+    if (!simDevice)
+        return NULL;
+
+    Ptr<Sim::HIDDevice> device = *new Sim::HIDDevice(this, simDevice);
+
+    if (device->HIDInitialize())
+    {
+        device->AddRef();
+        return device;
+    }
+
+    return NULL;
+}
+
+String HIDDeviceManager::Plug(const HIDDeviceConfig& config)
+{
+    String serial = config.SerialNumber;
+    if (serial.IsEmpty())
+    {
+        char buffer[32];
+        OVR_sprintf(buffer, sizeof(buffer), "SIM%05u", NextSerial++);
+        serial = buffer;
+    }
+
+    Ptr<SimulatedDevice> simDevice = *new SimulatedDevice(config, serial);
+    String               path      = simDevice->Desc.Path;
+
+    if (findDevice(path))
+    {
+        LogError("OVR::Sim::HIDDeviceManager - '%s' is already plugged in.\n", path.ToCStr());
+        return String();
+    }
+
+    simDevice->AddRef();
+    Devices.PushBack(simDevice);
+    LogText("OVR::Sim::HIDDeviceManager - Plugged in '%s'\n", path.ToCStr());
+
+    // A device we already have open was plugged back in, or a new one.
+    if (!Manager->pThread->OnDeviceMessage(
+            DeviceManagerThread::Notifier::DeviceMessage_DeviceAdded, path))
+    {
+        Manager->DetectHIDDevice(simDevice->Desc);
+    }
+    return path;
+}
+
+bool HIDDeviceManager::Unplug(const String& path)
+{
+    for (UPInt i = 0; i < Devices.GetSize(); i++)
+    {
+        if (Devices[i]->Desc.Path.CompareNoCase(path) == 0)
+        {
+            Devices[i]->Release();
+            Devices.RemoveAt(i);
+            LogText("OVR::Sim::HIDDeviceManager - Unplugged '%s'\n", path.ToCStr());
+
+            Manager->pThread->OnDeviceMessage(
+                DeviceManagerThread::Notifier::DeviceMessage_DeviceRemoved, path);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------
+// **** Sim::HIDDevice
+
+HIDDevice::HIDDevice(HIDDeviceManager* manager, SimulatedDevice* device, bool minimalMode)
+ :  inMinimalMode(minimalMode), HIDManager(manager), pDevice(device), Connected(true),
+    HandlerTicks(0), ReportTicks(0), SendTicks(0), Timestamp(0),
+    RandomState(device->Config.Seed),
+    TestStartedTicks(0), ColorDetectedTicks(0), TestStartTicks(0)
+{
+    memset(TestTarget, 0, sizeof(TestTarget));
+    memset(ReportBuffer, 0, sizeof(ReportBuffer));
+}
+
+HIDDevice::~HIDDevice()
+{
+    if (!inMinimalMode)
+    {
+        HIDShutdown();
+    }
+}
+
+bool HIDDevice::HIDInitialize()
+{
+    DeviceManagerThread* thread = HIDManager->Manager->pThread;
+
+    restartReports(Timer::GetTicks());
+    thread->AddTicksNotifier(this);
+    thread->AddMessageNotifier(this);
+
+    LogText("OVR::Sim::HIDDevice - Opened '%s'\n", pDevice->Desc.Path.ToCStr());
+    return true;
+}
+
+void HIDDevice::HIDShutdown()
+{
+    HIDManager->Manager->pThread->RemoveTicksNotifier(this);
+    HIDManager->Manager->pThread->RemoveMessageNotifier(this);
+
+    LogText("OVR::Sim::HIDDevice - Closed '%s'\n", pDevice->Desc.Path.ToCStr());
+}
+
+void HIDDevice::restartReports(UInt64 ticksMks)
+{
+    ReportTicks = ticksMks;
+    SendTicks   = ticksMks;
+}
+
+UInt32 HIDDevice::random()
+{
+    return NextRandom(&RandomState);
+}
+
+bool HIDDevice::SetFeatureReport(UByte* data, UInt32 length)
+{
+    if (!Connected)
+        return false;
+
+    UInt64 ticksMks  = Timer::GetTicks();
+    bool   streaming = (ticksMks < pDevice->KeepAliveTicks);
+
+    if (!pDevice->SetFeature(data, length))
+        return false;
+
+    if (inMinimalMode)
+        return true;
+
+    if (pDevice->Config.Kind == HIDDeviceConfig::Device_Tracker)
+    {
+        // A new packet interval, or a keep-alive after the tracker went quiet,
+        // starts the reports over.
+        if ((data[0] == Tracker_ConfigReport) ||
+            ((data[0] == Tracker_KeepAliveReport) && !streaming))
+        {
+            restartReports(ticksMks);
+            HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+        }
+    }
+    else if (data[0] == LatencyTester_StartTestReport && length >= 6)
+    {
+        // The tester reports the start right away, and the color change once
+        // the simulated latency has passed.
+        memcpy(TestTarget, data + 3, 3);
+        TestStartTicks     = ticksMks;
+        TestStartedTicks   = ticksMks;
+        ColorDetectedTicks = ticksMks + pDevice->Config.LatencyMks;
+        HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+    }
+    return true;
+}
+
+bool HIDDevice::GetFeatureReport(UByte* data, UInt32 length)
+{
+    if (!Connected)
+        return false;
+
+    return pDevice->GetFeature(data, length);
+}
+
+void HIDDevice::RestartTicks()
+{
+    if (!inMinimalMode)
+    {
+        HandlerTicks = 0;
+        HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+    }
+}
+
+UInt64 HIDDevice::serviceTracker(UInt64 ticksMks)
+{
+    enum { MaxReportsPerPass = 64 };
+
+    if (ticksMks >= pDevice->KeepAliveTicks)
+        return ~UInt64(0);
+
+    UInt64 interval = pDevice->GetReportInterval();
+    UInt64 samples  = interval / Timer::MksPerMs;
+    samples = (samples < 1) ? 1 : ((samples > 255) ? 255 : samples);
+
+    // After a stall, such as a debugger break, resume instead of catching up.
+    if (ticksMks > ReportTicks + Timer::MksPerSecond / 10)
+        restartReports(ticksMks);
+
+    UInt32 dropThreshold = UInt32(pDevice->Config.DropRate * 32768.0f);
+    UInt32 jitter        = pDevice->Config.JitterMks;
+
+    for (unsigned i = 0; (i < MaxReportsPerPass) && (SendTicks <= ticksMks); i++)
+    {
+        Timestamp = UInt16(Timestamp + samples);
+
+        if (!dropThreshold || (random() >= dropThreshold))
+        {
+            pDevice->Source->FillReport(ReportBuffer, UByte(samples), Timestamp, ReportTicks);
+            if (Handler)
+                Handler->OnInputReport(ReportBuffer, TrackerReportSource::ReportSize);
+        }
+
+        ReportTicks += interval;
+        SendTicks    = ReportTicks;
+        if (jitter)
+            SendTicks += (UInt64(random()) * jitter) >> 15;
+    }
+
+    return SendTicks;
+}
+
+UInt64 HIDDevice::serviceLatencyTester(UInt64 ticksMks)
+{
+    UInt16 timestamp = UInt16(ticksMks / Timer::MksPerMs);
+
+    if (TestStartedTicks && (TestStartedTicks <= ticksMks))
+    {
+        memset(ReportBuffer, 0, LatencyTester_ReportSize);
+        ReportBuffer[0] = LatencyTester_TestStartedReport;
+        EncodeUInt16(ReportBuffer + 1, 1);
+        EncodeUInt16(ReportBuffer + 3, timestamp);
+        memcpy(ReportBuffer + 5, TestTarget, 3);
+        TestStartedTicks = 0;
+
+        if (Handler)
+            Handler->OnInputReport(ReportBuffer, LatencyTester_ReportSize);
+    }
+
+    if (ColorDetectedTicks && (ColorDetectedTicks <= ticksMks))
+    {
+        memset(ReportBuffer, 0, LatencyTester_ReportSize);
+        ReportBuffer[0] = LatencyTester_ColorDetectedReport;
+        EncodeUInt16(ReportBuffer + 1, 1);
+        EncodeUInt16(ReportBuffer + 3, timestamp);
+        EncodeUInt16(ReportBuffer + 5, UInt16((ColorDetectedTicks - TestStartTicks) / Timer::MksPerMs));
+        memcpy(ReportBuffer + 7, TestTarget, 3);
+        memcpy(ReportBuffer + 10, TestTarget, 3);
+        ColorDetectedTicks = 0;
+
+        if (Handler)
+            Handler->OnInputReport(ReportBuffer, LatencyTester_ReportSize);
+    }
+
+    if (TestStartedTicks)
+        return TestStartedTicks;
+    return ColorDetectedTicks ? ColorDetectedTicks : ~UInt64(0);
+}
+
+UInt64 HIDDevice::OnTicks(UInt64 ticksMks)
+{
+    UInt64 deadline = ~UInt64(0);
+
+    if (Handler)
+    {
+        if (ticksMks >= HandlerTicks)
+        {
+            UInt64 waitAllowed = Handler->OnTicks(ticksMks);
+            HandlerTicks = (ticksMks + waitAllowed < ticksMks) ? ~UInt64(0) : (ticksMks + waitAllowed);
+        }
+        deadline = HandlerTicks;
+    }
+
+    if (Connected)
+    {
+        UInt64 reportTicks = (pDevice->Config.Kind == HIDDeviceConfig::Device_Tracker) ?
+                             serviceTracker(ticksMks) : serviceLatencyTester(ticksMks);
+        if (reportTicks < deadline)
+            deadline = reportTicks;
+    }
+
+    if (deadline == ~UInt64(0))
+        return DeviceManagerThread::Notifier::OnTicks(ticksMks);
+    return (deadline > ticksMks) ? (deadline - ticksMks) : 0;
+}
+
+bool HIDDevice::OnDeviceMessage(DeviceMessageType messageType,
+                                const String& devicePath,
+                                bool* error)
+{
+    // Is this the correct device?
+    if (pDevice->Desc.Path.CompareNoCase(devicePath) != 0)
+    {
+        return false;
+    }
+
+    if (messageType == DeviceMessage_DeviceAdded && !Connected)
+    {
+        // Plugged back in; that is a new SimulatedDevice, in its power-on state.
+        SimulatedDevice* simDevice = HIDManager->findDevice(devicePath);
+        if (!simDevice)
+        {
+            *error = true;
+            return true;
+        }
+
+        pDevice   = simDevice;
+        Connected = true;
+        restartReports(Timer::GetTicks());
+        HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+
+        LogText("OVR::Sim::HIDDevice - Reopened device '%s'\n", devicePath.ToCStr());
+    }
+    else if (messageType == DeviceMessage_DeviceRemoved)
+    {
+        Connected = false;
+    }
+
+    HIDHandler::HIDDeviceMessageType handlerMessageType = HIDHandler::HIDDeviceMessage_DeviceAdded;
+    if (messageType == DeviceMessage_DeviceRemoved)
+    {
+        handlerMessageType = HIDHandler::HIDDeviceMessage_DeviceRemoved;
+    }
+
+    if (Handler)
+    {
+        Handler->OnDeviceMessage(handlerMessageType);
+    }
+
+    *error = false;
+    return true;
+}
+
+}} // namespace OVR::Sim
@@ -0,0 +1,235 @@
+/************************************************************************************
+
+Filename    :   OVR_Sim_HIDDevice.h
+Content     :   Simulated HID devices: a tracker and a latency tester.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#ifndef OVR_Sim_HIDDevice_h
+#define OVR_Sim_HIDDevice_h
+
+#include "OVR_HIDDevice.h"
+#include "OVR_Sim_DeviceManager.h"
+
+#include "Kernel/OVR_Math.h"
+
+namespace OVR { namespace Sim {
+
+class HIDDeviceManager;
+class DeviceManager;
+class SimulatedDevice;
+
+//-------------------------------------------------------------------------------------
+// ***** TrackerReportSource
+
+// Source of the input reports a simulated tracker sends. Reports are 62 byte
+// tracker reports (report id 1) holding sampleCount samples taken 1 ms apart,
+// the last one at ticksMks; sampleCount and timestamp go in the header.
+
+class TrackerReportSource : public RefCountBase<TrackerReportSource>
+{
+public:
+    enum { ReportSize = 62 };
+
+    virtual ~TrackerReportSource() { }
+
+    virtual void FillReport(UByte* report, UByte sampleCount, UInt16 timestamp,
+                            UInt64 ticksMks) = 0;
+};
+
+// SyntheticMotion turns at a constant rate about the vertical axis, so gravity is
+// constant and the magnetic field rotates with it; Noise adds up to that many raw
+// units (10^-4 m/s^2, rad/s or gauss) of random error to every sample.
+class SyntheticMotion : public TrackerReportSource
+{
+public:
+    SyntheticMotion(float yawRate = 0.5f, SInt32 noise = 0, UInt32 seed = 1);
+
+    virtual void FillReport(UByte* report, UByte sampleCount, UInt16 timestamp,
+                            UInt64 ticksMks);
+
+private:
+    SInt32 noise();
+
+    float   YawRate;        // rad/s
+    SInt32  Noise;
+    UInt32  Seed;
+    UInt64  StartTicks;
+};
+
+// ReplayCapture plays back a capture of raw tracker reports, such as a copy of
+// /dev/hidrawN, one report per ReportSize bytes; it starts over at the end.
+// Captured headers are kept, so timestamps jump where the capture wraps.
+class ReplayCapture : public TrackerReportSource
+{
+public:
+    ReplayCapture() : NextReport(0) { }
+
+    // Loads the capture; returns 'false' if the file has no complete report.
+    bool LoadFile(const String& path);
+    void SetReports(const UByte* reports, UPInt reportCount);
+
+    UPInt GetReportCount() const { return Reports.GetSize() / ReportSize; }
+
+    virtual void FillReport(UByte* report, UByte sampleCount, UInt16 timestamp,
+                            UInt64 ticksMks);
+
+private:
+    ArrayPOD<UByte> Reports;
+    UPInt           NextReport;
+};
+
+
+//-------------------------------------------------------------------------------------
+// ***** HIDDeviceConfig
+
+// Describes a simulated device for Sim::DeviceManager::AddDevice.
+
+struct HIDDeviceConfig
+{
+    enum DeviceKind
+    {
+        Device_Tracker,
+        Device_LatencyTester
+    };
+
+    DeviceKind  Kind;
+    String      SerialNumber;   // Generated if empty.
+
+    // Tracker input reports per second. 0 follows the packet interval set through
+    // the Config feature report, as the hardware does (500 Hz after SensorDevice
+    // opens it). Reports carry the samples taken since the last one at 1 kHz, and
+    // at least one, so above 1000 Hz timestamps run ahead of real time.
+    unsigned    ReportRateHz;
+
+    // Each report is delivered up to this much later than due; the schedule
+    // itself doesn't drift.
+    UInt32      JitterMks;
+    // Fraction of tracker reports lost, 0..1. A lost report's samples still
+    // advance the timestamp, as when the host misses one.
+    float       DropRate;
+    // Seeds jitter and drops, so runs can be repeated.
+    UInt32      Seed;
+
+    // Where tracker reports come from; SyntheticMotion() if null.
+    Ptr<TrackerReportSource> Source;
+
+    // Returned in the tracker's DisplayInfo feature report; a zero HResolution
+    // reports no display, like older firmware. Defaults to the 7" DK1 panel.
+    HMDInfo     DisplayInfo;
+
+    // Latency tester: time from StartTest to the ColorDetected report.
+    UInt32      LatencyMks;
+
+    HIDDeviceConfig(DeviceKind kind = Device_Tracker);
+};
+
+
+//-------------------------------------------------------------------------------------
+// ***** Sim HIDDevice
+
+// An open simulated device. It generates input reports from OnTicks on the
+// DeviceManagerThread, so handlers see them on the same thread as real reports.
+// Reports that fell due while the thread slept are sent back to back, so the
+// report rate holds above the thread's timer resolution.
+
+class HIDDevice : public OVR::HIDDevice, public DeviceManagerThread::Notifier
+{
+public:
+
+    HIDDevice(HIDDeviceManager* manager, SimulatedDevice* device, bool minimalMode = false);
+    ~HIDDevice();
+
+    bool HIDInitialize();
+    void HIDShutdown();
+
+    // OVR::HIDDevice
+    bool SetFeatureReport(UByte* data, UInt32 length);
+    bool GetFeatureReport(UByte* data, UInt32 length);
+
+    // DeviceManagerThread::Notifier
+    UInt64 OnTicks(UInt64 ticksMks);
+    bool OnDeviceMessage(DeviceMessageType messageType, const String& devicePath, bool* error);
+
+private:
+    // OVR::HIDDevice
+    void RestartTicks();
+
+    // Send the input reports due by ticksMks. Return when the next one is due,
+    // or ~0 if none is.
+    UInt64 serviceTracker(UInt64 ticksMks);
+    UInt64 serviceLatencyTester(UInt64 ticksMks);
+
+    void   restartReports(UInt64 ticksMks);
+    // Random number in [0, 32767], from the config's seed.
+    UInt32 random();
+
+    bool                    inMinimalMode;
+    HIDDeviceManager*       HIDManager;
+    Ptr<SimulatedDevice>    pDevice;
+    bool                    Connected;
+
+    // Next time the handler's OnTicks is due.
+    UInt64                  HandlerTicks;
+
+    // Tracker stream: when the next report is due and, with jitter, sent.
+    UInt64                  ReportTicks;
+    UInt64                  SendTicks;
+    UInt16                  Timestamp;
+    UInt32                  RandomState;
+
+    // Latency tester: reports pending for the last StartTest, 0 when sent.
+    UInt64                  TestStartedTicks;
+    UInt64                  ColorDetectedTicks;
+    UInt64                  TestStartTicks;
+    UByte                   TestTarget[3];
+
+    enum { ReportBufferSize = 64 };
+    UByte                   ReportBuffer[ReportBufferSize];
+};
+
+//-------------------------------------------------------------------------------------
+// ***** Sim HIDDeviceManager
+
+// Keeps the simulated devices that are plugged in. A device's Path is
+// "sim://<kind>/<serial>"; its feature report state lives as long as it stays
+// plugged in, across opens, like the hardware's.
+
+class HIDDeviceManager : public OVR::HIDDeviceManager
+{
+    friend class HIDDevice;
+public:
+
+    HIDDeviceManager(DeviceManager* manager);
+    virtual ~HIDDeviceManager();
+
+    virtual bool Enumerate(HIDEnumerateVisitor* enumVisitor);
+    virtual OVR::HIDDevice* Open(const String& path);
+
+    // Fills HIDDeviceDesc by using the path.
+    // Returns 'true' if successful, 'false' otherwise.
+    bool GetHIDDeviceDesc(const String& path, HIDDeviceDesc* pdevDesc) const;
+
+    // Plug/unplug; must be called on the DeviceManagerThread.
+    String  Plug(const HIDDeviceConfig& config);
+    bool    Unplug(const String& path);
+
+private:
+    SimulatedDevice* findDevice(const String& path) const;
+
+    DeviceManager*              Manager;     // Back pointer can just be a raw pointer.
+    // Plugged in devices; each holds a reference.
+    ArrayPOD<SimulatedDevice*>  Devices;
+    unsigned                    NextSerial;
+};
+
+}} // namespace OVR::Sim
+
+#endif // OVR_Sim_HIDDevice_h
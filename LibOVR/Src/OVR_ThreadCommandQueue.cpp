@@ -15,148 +15,14 @@ otherwise accompanies this software in either electronic or hard copy form.
 
 #include "OVR_ThreadCommandQueue.h"
 
-namespace OVR {
-
-
-//------------------------------------------------------------------------
-// ***** CircularBuffer
-
-// CircularBuffer is a FIFO buffer implemented in a single block of memory,
-// which allows writing and reading variable-size data chucks. Write fails
-// if buffer is full.
-
-class CircularBuffer
-{
-    enum {
-        AlignSize = 16,
-        AlignMask = AlignSize - 1
-    };
-
-    UByte*  pBuffer;
-    UPInt   Size;
-    UPInt   Tail;   // Byte offset of next item to be popped.
-    UPInt   Head;   // Byte offset of where next push will take place.
-    UPInt   End;    // When Head < Tail, this is used instead of Size.    
-
-    inline UPInt roundUpSize(UPInt size)
-    { return (size + AlignMask) & ~(UPInt)AlignMask; }
-
-public:
-
-    CircularBuffer(UPInt size)
-        : Size(size), Tail(0), Head(0), End(0)
-    {
-        pBuffer = (UByte*)OVR_ALLOC_ALIGNED(roundUpSize(size), AlignSize);
-    }
-    ~CircularBuffer()
-    {
-        // For ThreadCommands, we must consume everything before shutdown.
-        OVR_ASSERT(IsEmpty());
-        OVR_FREE_ALIGNED(pBuffer);
-    }
-
-    bool    IsEmpty() const { return (Head == Tail); }
-
-    // Allocates a state block of specified size and advances pointers,
-    // returning 0 if buffer is full.
-    UByte*  Write(UPInt size);
-
-    // Returns a pointer to next available data block; 0 if none available.
-    UByte*  ReadBegin()
-    { return (Head != Tail) ? (pBuffer + Tail) : 0; }
-    // Consumes data of specified size; this must match size passed to Write.
-    void    ReadEnd(UPInt size);
-};
-
-
-// Allocates a state block of specified size and advances pointers,
-// returning 0 if buffer is full.
-UByte* CircularBuffer::Write(UPInt size)
-{
-    UByte* p = 0;
-
-    size = roundUpSize(size);
-    // Since this is circular buffer, always allow at least one item.
-    OVR_ASSERT(size < Size/2);
-
-    if (Head >= Tail)
-    {
-        OVR_ASSERT(End == 0);
-        
-        if (size <= (Size - Head))
-        {
-            p    = pBuffer + Head;
-            Head += size;
-        }
-        else if (size < Tail)
-        {
-            p    = pBuffer;
-            End  = Head;
-            Head = size;
-            OVR_ASSERT(Head != Tail);
-        }
-    }
-    else
-    {
-        OVR_ASSERT(End != 0);
-
-        if ((Tail - Head) > size)
-        {
-            p    = pBuffer + Head;
-            Head += size;
-            OVR_ASSERT(Head != Tail);
-        }
-    }
-
-    return p;
-}
-
-void CircularBuffer::ReadEnd(UPInt size)
-{
-    OVR_ASSERT(Head != Tail);
-    size = roundUpSize(size);
-    
-    Tail += size;        
-    if (Tail == End)
-    {
-        Tail = End = 0;
-    }
-    else if (Tail == Head)
-    {        
-        OVR_ASSERT(End == 0);
-        Tail = Head = 0;
-    }
-}
-
-
-//-------------------------------------------------------------------------------------
-// ***** ThreadCommand
-
-ThreadCommand::PopBuffer::~PopBuffer()
-{
-    if (Size)
-        Destruct<ThreadCommand>(toCommand());
-}
-
-void ThreadCommand::PopBuffer::InitFromBuffer(void* data)
-{
-    ThreadCommand* cmd = (ThreadCommand*)data;
-    OVR_ASSERT(cmd->Size <= MaxSize);
+#ifdef OVR_OS_LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
-    if (Size)
-        Destruct<ThreadCommand>(toCommand());    
-    Size = cmd->Size;    
-    memcpy(Buffer, (void*)cmd, Size);
-}
+namespace OVR {
 
-void ThreadCommand::PopBuffer::Execute()
-{
-    ThreadCommand* command = toCommand();
-    OVR_ASSERT(command);
-    command->Execute();
-    if (NeedsWait())
-        GetEvent()->PulseEvent();
-}
 
 //-------------------------------------------------------------------------------------
 
@@ -164,14 +30,11 @@ class ThreadCommandQueueImpl : public NewOverrideBase
 {
     typedef ThreadCommand::NotifyEvent NotifyEvent;
     friend class ThreadCommandQueue;
+    friend class ThreadCommand::PopBuffer;
     
 public:
 
-    ThreadCommandQueueImpl(ThreadCommandQueue* queue)
-        : pQueue(queue), CommandBuffer(2048),
-          ExitEnqueued(false), ExitProcessed(false)
-    {
-    }
+    ThreadCommandQueueImpl(ThreadCommandQueue* queue, UPInt capacity);
     ~ThreadCommandQueueImpl();
 
 
@@ -191,106 +54,214 @@ public:
         {
             Lock::Locker lock(&pImpl->QueueLock);
             pImpl->ExitProcessed = true;
+            // Nothing will be popped any more; let blocked producers fail.
+            pImpl->WakeBlockedProducers_NTS();
         }
         virtual ThreadCommand* CopyConstruct(void* p) const 
         { return Construct<ExitCommand>(p, *this); }
     };
 
 
-    NotifyEvent* AllocNotifyEvent_NTS()
+    // Removes the first blocked producer from the list, without waking it.
+    // Returns 0 if there is none.
+    NotifyEvent* PopBlockedProducer_NTS()
     {
-        NotifyEvent* p = AvailableEvents.GetFirst();
-
-        if (!AvailableEvents.IsNull(p))
-            p->RemoveNode();        
-        else
-            p = new NotifyEvent;
-        return p;
+        if (BlockedProducers.IsEmpty())
+            return 0;
+        NotifyEvent* queueAvailableEvent = BlockedProducers.GetFirst();
+        queueAvailableEvent->RemoveNode();
+        BlockedCount.ExchangeAdd_NoSync((UInt32)-1);
+        return queueAvailableEvent;
     }
 
-    void         FreeNotifyEvent_NTS(NotifyEvent* p)
+    // Releases all blocked producers.
+    void        WakeBlockedProducers_NTS()
     {
-        AvailableEvents.PushBack(p);
+        // The event belongs to the waiter, who may return as soon as it's pulsed.
+        while (NotifyEvent* queueAvailableEvent = PopBlockedProducer_NTS())
+            queueAvailableEvent->PulseEvent();
     }
 
-    void        FreeNotifyEvents_NTS()
+private:
+
+    // Ring slot. Sequence equals the position a producer may claim the slot at,
+    // position + 1 once the command in it is ready, and position + Capacity once the
+    // consumer has freed it again (bounded MPMC queue scheme, single consumer).
+    struct Slot
     {
-        while(!AvailableEvents.IsEmpty())
-        {
-            NotifyEvent* p = AvailableEvents.GetFirst();
-            p->RemoveNode();
-            delete p;
-        }
-    }
+        AtomicInt<UInt32>   Sequence;
+        bool                Cancelled;  // Claimed after exit; holds no command.
+        union {
+            UByte           Buffer[ThreadCommand::MaxSize];
+            UPInt           Align;
+        };
+    };
 
+    enum PushResult
+    {
+        Push_Done,
+        Push_Full,
+        Push_Closed
+    };
+
+    PushResult  tryPush(const ThreadCommand& command, NotifyEvent* completeEvent);
+    bool        isFull() const;
+    void        freeSlot(UInt32 position);
+    void        wakeConsumer();
+
+public:
     ThreadCommandQueue* pQueue;
     Lock                QueueLock;
-    volatile bool       ExitEnqueued;
+    AtomicInt<UInt32>   ExitEnqueued;
     volatile bool       ExitProcessed;
-    List<NotifyEvent>   AvailableEvents;
     List<NotifyEvent>   BlockedProducers;
-    CircularBuffer      CommandBuffer;
+
+private:
+    Slot*               pSlots;
+    UInt32              Capacity;
+    UInt32              Mask;
+    AtomicInt<UInt32>   EnqueuePos;
+    UInt32              DequeuePos;     // Only touched by the consumer.
+    AtomicInt<UInt32>   BlockedCount;   // Size of BlockedProducers, readable without the lock.
+    AtomicInt<UInt32>   ConsumerWaiting;
 };
 
 
+ThreadCommandQueueImpl::ThreadCommandQueueImpl(ThreadCommandQueue* queue, UPInt capacity)
+    : pQueue(queue), ExitEnqueued(0), ExitProcessed(false),
+      EnqueuePos(0), DequeuePos(0), BlockedCount(0), ConsumerWaiting(0)
+{
+    Capacity = 2;
+    while (Capacity < capacity)
+        Capacity <<= 1;
+    Mask = Capacity - 1;
+
+    pSlots = (Slot*)OVR_ALLOC_ALIGNED(sizeof(Slot) * Capacity, 16);
+    for (UInt32 i = 0; i < Capacity; i++)
+    {
+        pSlots[i].Sequence  = i;
+        pSlots[i].Cancelled = false;
+    }
+}
 
 ThreadCommandQueueImpl::~ThreadCommandQueueImpl()
 {
     Lock::Locker lock(&QueueLock);
     OVR_ASSERT(BlockedProducers.IsEmpty());
-    FreeNotifyEvents_NTS();
+    // For ThreadCommands, we must consume everything before shutdown.
+    OVR_ASSERT(pSlots[DequeuePos & Mask].Sequence != DequeuePos + 1 ||
+               pSlots[DequeuePos & Mask].Cancelled);
+    OVR_FREE_ALIGNED(pSlots);
+}
+
+// Claims the next slot and constructs command in it, or reports why it couldn't.
+ThreadCommandQueueImpl::PushResult
+ThreadCommandQueueImpl::tryPush(const ThreadCommand& command, NotifyEvent* completeEvent)
+{
+    OVR_ASSERT(command.GetSize() <= ThreadCommand::MaxSize);
+
+    // Don't allow any commands after PushExitCommand() is called.
+    if (ExitEnqueued && !command.ExitFlag)
+        return Push_Closed;
+
+    UInt32 pos  = EnqueuePos;
+    Slot*  slot;
+
+    while (true)
+    {
+        slot = pSlots + (pos & Mask);
+        SInt32 diff = (SInt32)(slot->Sequence.Load_Acquire() - pos);
+
+        if (diff == 0)
+        {
+            if (EnqueuePos.CompareAndSet_Sync(pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // The consumer hasn't freed this slot since the last lap.
+            return Push_Full;
+        }
+        pos = EnqueuePos;
+    }
+
+    // PushExitCommand sets ExitEnqueued before claiming its slot, so if it is
+    // still clear here the exit command will be queued after us. Otherwise it
+    // may be ahead of us; the slot must still be published for the consumer
+    // to move past it, but without a command.
+    bool cancelled = ExitEnqueued && !command.ExitFlag;
+
+    slot->Cancelled = cancelled;
+    if (!cancelled)
+    {
+        ThreadCommand* c = command.CopyConstruct(slot->Buffer);
+        if (c->NeedsWait())
+            c->pEvent = completeEvent;
+    }
+
+    // The exchange also orders the publish before reading ConsumerWaiting.
+    slot->Sequence.Exchange_Sync(pos + 1);
+    if (ConsumerWaiting)
+        wakeConsumer();
+
+    return cancelled ? Push_Closed : Push_Done;
+}
+
+bool ThreadCommandQueueImpl::isFull() const
+{
+    UInt32 pos = EnqueuePos;
+    return (SInt32)(pSlots[pos & Mask].Sequence.Load_Acquire() - pos) < 0;
+}
+
+void ThreadCommandQueueImpl::wakeConsumer()
+{
+    Lock::Locker lock(&QueueLock);
+    if (ConsumerWaiting)
+    {
+        ConsumerWaiting = 0;
+        pQueue->OnPushNonEmpty_Locked();
+    }
 }
 
 bool ThreadCommandQueueImpl::PushCommand(const ThreadCommand& command)
 {
-    ThreadCommand::NotifyEvent* completeEvent = 0;
-    ThreadCommand::NotifyEvent* queueAvailableEvent = 0;
+    NotifyEvent completeEvent;
+    PushResult  result;
 
     // Repeat  writing command into buffer until it is available.    
-    do {
+    while ((result = tryPush(command, &completeEvent)) == Push_Full)
+    {
+        NotifyEvent queueAvailableEvent;
 
         { // Lock Scope
             Lock::Locker lock(&QueueLock);
 
-            if (queueAvailableEvent)
-            {
-                FreeNotifyEvent_NTS(queueAvailableEvent);
-                queueAvailableEvent = 0;
-            }
-
-            // Don't allow any commands after PushExitCommand() is called.
-            if (ExitEnqueued && !command.ExitFlag)
-                return false;
-
+            // The consumer is gone and won't free any slots; or the queue is
+            // closing, and only the exit command may wait for one.
+            if (ExitProcessed || (ExitEnqueued && !command.ExitFlag))
+                break;
 
-            bool   bufferWasEmpty = CommandBuffer.IsEmpty();
-            UByte* buffer = CommandBuffer.Write(command.GetSize());
-            if  (buffer)
+            // Count ourselves before checking again, so that either we see the
+            // slot the consumer frees or it sees us waiting.
+            BlockedCount.ExchangeAdd_Sync(1);
+            if (!isFull())
             {
-                ThreadCommand* c = command.CopyConstruct(buffer);
-                if (c->NeedsWait())
-                    completeEvent = c->pEvent = AllocNotifyEvent_NTS();
-                // Signal-waker consumer when we add data to buffer.
-                if (bufferWasEmpty)
-                    pQueue->OnPushNonEmpty_Locked();
-                break;
+                BlockedCount.ExchangeAdd_NoSync((UInt32)-1);
+                continue;
             }
 
-            queueAvailableEvent = AllocNotifyEvent_NTS();
-            BlockedProducers.PushBack(queueAvailableEvent);
+            BlockedProducers.PushBack(&queueAvailableEvent);
         } // Lock Scope
 
-        queueAvailableEvent->Wait();
+        queueAvailableEvent.Wait();
+    }
 
-    } while(1);
+    if (result != Push_Done)
+        return false;
 
     // Command was enqueued, wait if necessary.
-    if (completeEvent)
-    {
-        completeEvent->Wait();
-        Lock::Locker lock(&QueueLock);
-        FreeNotifyEvent_NTS(completeEvent);
-    }
+    if (command.NeedsWait())
+        completeEvent.Wait();
 
     return true;
 }
@@ -299,35 +270,155 @@ bool ThreadCommandQueueImpl::PushCommand(const ThreadCommand& command)
 // Pops the next command from the thread queue, if any is available.
 bool ThreadCommandQueueImpl::PopCommand(ThreadCommand::PopBuffer* popBuffer)
 {    
-    Lock::Locker lock(&QueueLock);
+    popBuffer->release();
 
-    UByte* buffer = CommandBuffer.ReadBegin();
-    if (!buffer)
+    while (true)
     {
+        UInt32 pos  = DequeuePos;
+        Slot*  slot = pSlots + (pos & Mask);
+
+        if (slot->Sequence.Load_Acquire() == pos + 1)
+        {
+            DequeuePos = pos + 1;
+            if (slot->Cancelled)
+            {
+                freeSlot(pos);
+                continue;
+            }
+
+            popBuffer->pCommand = (ThreadCommand*)slot->Buffer;
+            popBuffer->pQueue   = this;
+            popBuffer->Position = pos;
+            return true;
+        }
+
+        // Empty. Announce that we are about to wait, then look again, so that a
+        // producer either sees the flag or has its command seen here.
+        Lock::Locker lock(&QueueLock);
+        ConsumerWaiting.Exchange_Sync(1);
+        if (slot->Sequence.Load_Acquire() == pos + 1)
+        {
+            ConsumerWaiting = 0;
+            continue;
+        }
+
         // Notify thread while in lock scope, enabling initialization of wait.
         pQueue->OnPopEmpty_Locked();
         return false;
     }
+}
 
-    popBuffer->InitFromBuffer(buffer);
-    CommandBuffer.ReadEnd(popBuffer->GetSize());
+// Hands the slot at position back to producers, waking one if any are blocked.
+void ThreadCommandQueueImpl::freeSlot(UInt32 position)
+{
+    // The exchange also orders the free before reading BlockedCount.
+    pSlots[position & Mask].Sequence.Exchange_Sync(position + Capacity);
 
-    if (!BlockedProducers.IsEmpty())
+    if (BlockedCount)
     {
-        ThreadCommand::NotifyEvent* queueAvailableEvent = BlockedProducers.GetFirst();
-        queueAvailableEvent->RemoveNode();
-        queueAvailableEvent->PulseEvent();
-        // Event is freed later by waiter.
-    }    
-    return true;
+        NotifyEvent* queueAvailableEvent;
+        {
+            Lock::Locker lock(&QueueLock);
+            queueAvailableEvent = PopBlockedProducer_NTS();
+        }
+        // Pulse after unlocking: the woken producer often runs right away, and
+        // would block on QueueLock again if we still held it. Once off the list
+        // the event can only be pulsed here, so its waiter is still there.
+        if (queueAvailableEvent)
+            queueAvailableEvent->PulseEvent();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** ThreadCommand
+
+// Pulses are usually answered within microseconds when the consumer thread is
+// awake, so the waiter polls this many times before paying for a sleep. With a
+// single CPU the pulse can't come while we spin, so don't.
+enum { NotifyEventSpinCount = 1000 };
+
+static int notifyEventSpinCount()
+{
+    static int spinCount = -1;
+    if (spinCount < 0)
+        spinCount = (Thread::GetCPUCount() > 1) ? NotifyEventSpinCount : 0;
+    return spinCount;
+}
+
+static inline void spinPause()
+{
+#if defined(OVR_CC_GNU) && (defined(OVR_CPU_X86) || defined(OVR_CPU_X86_64))
+    asm volatile("pause" ::: "memory");
+#endif
+}
+
+void ThreadCommand::NotifyEvent::Wait()
+{
+    for (int i = 0, spinCount = notifyEventSpinCount(); i < spinCount; i++)
+    {
+        if (State.Load_Acquire() == State_Signaled)
+            return;
+        spinPause();
+    }
+
+    // Tell PulseEvent that it has to wake us; fails if it already ran.
+    if (!State.CompareAndSet_Sync(State_Pending, State_Parked))
+        return;
+
+#ifdef OVR_OS_LINUX
+    // Returns early if State is no longer Parked; spurious wakeups just loop.
+    while (State.Load_Acquire() != State_Signaled)
+        syscall(SYS_futex, &State.Value, FUTEX_WAIT_PRIVATE, State_Parked, 0, 0, 0);
+#else
+    E.Wait();
+#endif
+}
+
+void ThreadCommand::NotifyEvent::PulseEvent()
+{
+    if (State.Exchange_Sync(State_Signaled) != State_Parked)
+        return;
+
+#ifdef OVR_OS_LINUX
+    // The waiter may already have seen the new State and returned, leaving this
+    // to wake an address that is gone. That's harmless: a futex wait on whatever
+    // reuses it only sees a spurious wakeup.
+    syscall(SYS_futex, &State.Value, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#else
+    E.SetEvent();
+#endif
+}
+
+void ThreadCommand::PopBuffer::release()
+{
+    if (pCommand)
+    {
+        Destruct<ThreadCommand>(pCommand);
+        pCommand = 0;
+        pQueue->freeSlot(Position);
+    }
+}
+
+void ThreadCommand::PopBuffer::Execute()
+{
+    ThreadCommand* command = pCommand;
+    OVR_ASSERT(command);
+    command->Execute();
+
+    // Free the slot before releasing a waiting producer, which may push again.
+    NotifyEvent* event = NeedsWait() ? GetEvent() : 0;
+    release();
+    if (event)
+        event->PulseEvent();
 }
 
 
 //-------------------------------------------------------------------------------------
 
-ThreadCommandQueue::ThreadCommandQueue()
+ThreadCommandQueue::ThreadCommandQueue(UPInt capacity)
 {
-    pImpl = new ThreadCommandQueueImpl(this);
+    pImpl = new ThreadCommandQueueImpl(this, capacity);
 }
 ThreadCommandQueue::~ThreadCommandQueue()
 {
@@ -355,7 +446,12 @@ void ThreadCommandQueue::PushExitCommand(bool wait)
         Lock::Locker lock(&pImpl->QueueLock);
         if (pImpl->ExitEnqueued)
             return;
-        pImpl->ExitEnqueued = true;
+        // Full barrier: producers that miss this must have claimed their slot first.
+        pImpl->ExitEnqueued.Exchange_Sync(1);
+        // Release producers blocked on a full queue; they will now fail. This
+        // leaves the exit command the only one that can block, so the single
+        // wake each freed slot sends always reaches it.
+        pImpl->WakeBlockedProducers_NTS();
     }
 
     PushCommand(ThreadCommandQueueImpl::ExitCommand(pImpl, wait));
@@ -26,6 +26,7 @@ namespace OVR {
 
 class ThreadCommand;
 class ThreadCommandQueue;
+class ThreadCommandQueueImpl;
 
 
 //-------------------------------------------------------------------------------------
@@ -38,45 +39,56 @@ public:
 
     // NotifyEvent is used by ThreadCommandQueue::PushCallAndWait to notify the
     // calling (producer)  thread when command is completed or queue slot is available.
-    class NotifyEvent : public ListNode<NotifyEvent>, public NewOverrideBase
+    // It is a one-shot token living on the waiting thread's stack. Wait() spins for a
+    // while before parking the thread, so a command that completes within the spin
+    // costs no system calls; parking uses a futex on Linux and an Event elsewhere.
+    class NotifyEvent : public ListNode<NotifyEvent>
     {
-        Event E;
+        enum { State_Pending, State_Parked, State_Signaled };
+
+        AtomicInt<UInt32>   State;
+#ifndef OVR_OS_LINUX
+        Event               E;
+#endif
     public:   
-        NotifyEvent() { }
+        NotifyEvent() : State(State_Pending) { }
 
-        void Wait()        { E.Wait(); }
-        void PulseEvent()  { E.PulseEvent(); }
+        // Returns once PulseEvent has been called, which may be before Wait.
+        void Wait();
+        void PulseEvent();
     };
 
-    // ThreadCommand::PopBuffer is temporary storage for a command popped off
-    // by ThreadCommandQueue::PopCommand. 
+    // ThreadCommand::PopBuffer refers to a command popped off by
+    // ThreadCommandQueue::PopCommand. The command is not copied out; it is executed
+    // in its queue slot, which is handed back to producers after Execute() (or when
+    // the PopBuffer is reused or destroyed without executing it).
     class PopBuffer
     {
-        enum { MaxSize = 256 };
+        friend class ThreadCommandQueueImpl;
 
-        UPInt Size;
-        union {            
-            UByte Buffer[MaxSize];
-            UPInt Align;
-        };
+        ThreadCommand*          pCommand;
+        ThreadCommandQueueImpl* pQueue;
+        UInt32                  Position;   // Queue position of the command's slot.
 
-        ThreadCommand* toCommand() const { return (ThreadCommand*)Buffer; }
+        // Destroys the command and frees its slot.
+        void        release();
 
     public:
-        PopBuffer() : Size(0) { }
-        ~PopBuffer();
-
-        void        InitFromBuffer(void* data);
+        PopBuffer() : pCommand(0), pQueue(0), Position(0) { }
+        ~PopBuffer() { release(); }
 
-        bool        HasCommand() const  { return Size != 0; }
-        UPInt       GetSize() const     { return Size; }
-        bool        NeedsWait() const   { return toCommand()->NeedsWait(); }
-        NotifyEvent* GetEvent() const   { return toCommand()->pEvent; }
+        bool        HasCommand() const  { return pCommand != 0; }
+        UPInt       GetSize() const     { return pCommand ? pCommand->GetSize() : 0; }
+        bool        NeedsWait() const   { return pCommand->NeedsWait(); }
+        NotifyEvent* GetEvent() const   { return pCommand->pEvent; }
 
         // Execute the command and also notifies caller to finish waiting,
         // if necessary.
         void        Execute();
     };
+
+    // Largest command a queue slot can hold.
+    enum { MaxSize = 256 };
     
     UInt16       Size;
     bool         WaitFlag; 
@@ -210,12 +222,19 @@ public:
 // serviced by a single consumer thread. Commands are added to the queue with PushCall
 // and removed with PopCall; they are processed in FIFO order. Multiple producer threads
 // are supported and will be blocked if internal data buffer is full.
+//
+// The buffer is a lock-free ring of fixed-size slots: producers claim a slot with a
+// single compare-and-set and construct the command in it, and the consumer executes
+// it in place. The internal lock is only taken to block or wake a thread.
 
 class ThreadCommandQueue
 {
 public:
+    enum { DefaultCapacity = 64 };
 
-    ThreadCommandQueue();
+    // Capacity is the number of commands that can be queued before producers
+    // block; it is rounded up to a power of two.
+    ThreadCommandQueue(UPInt capacity = DefaultCapacity);
     virtual ~ThreadCommandQueue();
 
 
@@ -236,7 +255,9 @@ public:
 
 
     // These two virtual functions serve as notifications for derived
-    // thread waiting.    
+    // thread waiting. Both are called with the queue's internal lock held:
+    // OnPopEmpty_Locked when PopCommand finds the queue empty, and
+    // OnPushNonEmpty_Locked when a command is pushed after that.
     virtual void OnPushNonEmpty_Locked() { }
     virtual void OnPopEmpty_Locked()     { }
 
@@ -17,6 +17,7 @@ otherwise accompanies this software in either electronic or hard copy form.
 #define OVR_Win32_DeviceManager_h
 
 #include "OVR_DeviceImpl.h"
+#include "OVR_DeadlineQueue.h"
 #include "OVR_Win32_DeviceStatus.h"
 
 #include "Kernel/OVR_Timer.h"
@@ -78,9 +79,9 @@ public:
 		// Called when overlapped I/O handle is signaled.
         virtual void    OnOverlappedEvent(HANDLE hevent) { OVR_UNUSED1(hevent); }
 
-        // Called when timing ticks are updated.
+        // Called once the notifier's tick deadline has passed.
         // Returns the largest number of microseconds this function can
-        // wait till next call.
+        // wait till next call; that sets the next deadline.
         virtual UInt64  OnTicks(UInt64 ticksMks)
         { OVR_UNUSED1(ticksMks);  return Timer::MksPerSecond * 1000; }
 
@@ -103,10 +104,16 @@ public:
     bool AddOverlappedEvent(Notifier* notify, HANDLE hevent);
     bool RemoveOverlappedEvent(Notifier* notify, HANDLE hevent);
 
-    // Add notifier that will be called at regular intervals. 
+    // Add notifier that will be called at regular intervals. Its first
+    // OnTicks call happens on the next pass through the thread loop.
     bool AddTicksNotifier(Notifier* notify);
     bool RemoveTicksNotifier(Notifier* notify);
 
+    // Moves notifier's next OnTicks call to the absolute time ticksMks
+    // (Timer::GetTicks), e.g. 0 for as soon as possible.
+    // Returns 'false' if the notifier isn't registered.
+    bool ScheduleTicks(Notifier* notify, UInt64 ticksMks);
+
 	bool AddMessageNotifier(Notifier* notify);
 	bool RemoveMessageNotifier(Notifier* notify);
 
@@ -127,8 +134,9 @@ private:
     Array<HANDLE>           WaitHandles;
     Array<Notifier*>        WaitNotifiers;
 
-    // Ticks notifiers - used for time-dependent events such as keep-alive.
-    Array<Notifier*>        TicksNotifiers;
+    // Ticks notifiers - used for time-dependent events such as keep-alive,
+    // ordered by when each wants its next OnTicks call.
+    DeadlineQueue<Notifier*> TicksNotifiers;
 
 	// Message notifiers.
     Array<Notifier*>        MessageNotifiers;
@@ -515,6 +515,12 @@ void HIDDevice::OnOverlappedEvent(HANDLE hevent)
     }
 }
 
+void HIDDevice::RestartTicks()
+{
+    if (!inMinimalMode)
+        HIDManager->Manager->pThread->ScheduleTicks(this, 0);
+}
+
 UInt64 HIDDevice::OnTicks(UInt64 ticksMks)
 {
     if (Handler)
@@ -100,6 +100,9 @@ public:
     bool OnDeviceMessage(DeviceMessageType messageType, const String& devicePath, bool* error);
 
 private:
+    // OVR::HIDDevice
+    void RestartTicks();
+
     bool openDevice();
     bool initInfo();
     bool initializeRead();
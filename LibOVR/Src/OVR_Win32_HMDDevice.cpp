@@ -38,6 +38,7 @@ HMDDeviceCreateDesc::HMDDeviceCreateDesc(const HMDDeviceCreateDesc& other)
           HResolution(other.HResolution), VResolution(other.VResolution),
           HScreenSize(other.HScreenSize), VScreenSize(other.VScreenSize)
 {
+    memcpy(DistortionK, other.DistortionK, sizeof(float)*4);
 }
 
 HMDDeviceCreateDesc::MatchResult HMDDeviceCreateDesc::MatchDevice(const DeviceCreateDesc& other,
@@ -0,0 +1,199 @@
+/************************************************************************************
+
+Filename    :   Test_LinuxHidraw.cpp
+Content     :   Opens a tracker through a fake sysfs/hidraw tree, using the
+                OVR_HIDRAW_ROOT hook of the Linux HID backend.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR.h"
+#include "Kernel/OVR_Threads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace OVR;
+
+// The tree mirrors what the kernel shows for a DK1 tracker: the hidraw node's
+// "device" link points at the HID device, whose grandparent is the USB device
+// holding the string descriptors.
+//
+//   <root>/dev/hidraw0                               FIFO standing in for the node
+//   <root>/sys/class/hidraw/hidraw0/device   ->      <usb>/1-1:1.0/0003:2833:0001.0001
+//   <usb>/1-1:1.0/0003:2833:0001.0001/uevent, report_descriptor
+//   <usb>/manufacturer, product, serial, bcdDevice
+//
+// Feature report ioctls fail on the FIFO, which the sensor code tolerates, and
+// input reports written to it are read back like hidraw reports.
+
+static int Failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what);
+        Failures++;
+    }
+}
+
+static bool makeDir(const String& path)
+{
+    return ::mkdir(path.ToCStr(), 0755) == 0;
+}
+
+static bool writeFile(const String& path, const void* data, UPInt size)
+{
+    FILE* f = fopen(path.ToCStr(), "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    return (fclose(f) == 0) && ok;
+}
+
+static bool writeText(const String& path, const char* text)
+{
+    return writeFile(path, text, strlen(text));
+}
+
+static bool buildTree(const String& root)
+{
+    static const UByte reportDescriptor[] =
+    {
+        0x06, 0x00, 0xFF,   // Usage Page (vendor 0xFF00)
+        0x09, 0x01,         // Usage (1)
+        0xA1, 0x01,         // Collection (Application)
+        0xC0                // End Collection
+    };
+
+    String usb    = root + "/sys/devices/usb1/1-1";
+    String hidDev = usb + "/1-1:1.0/0003:2833:0001.0001";
+
+    return makeDir(root + "/sys") && makeDir(root + "/sys/devices") &&
+           makeDir(root + "/sys/devices/usb1") && makeDir(usb) &&
+           makeDir(usb + "/1-1:1.0") && makeDir(hidDev) &&
+           writeText(usb + "/manufacturer", "Oculus VR, Inc.\n") &&
+           writeText(usb + "/product", "Tracker DK\n") &&
+           writeText(usb + "/serial", "FAKE0001\n") &&
+           writeText(usb + "/bcdDevice", "0118\n") &&
+           writeText(hidDev + "/uevent",
+                     "DRIVER=hid-generic\nHID_ID=0003:00002833:00000001\n"
+                     "HID_NAME=Oculus VR, Inc. Tracker DK\n") &&
+           writeFile(hidDev + "/report_descriptor", reportDescriptor, sizeof(reportDescriptor)) &&
+           makeDir(root + "/sys/class") && makeDir(root + "/sys/class/hidraw") &&
+           makeDir(root + "/sys/class/hidraw/hidraw0") &&
+           ::symlink(hidDev.ToCStr(), (root + "/sys/class/hidraw/hidraw0/device").ToCStr()) == 0 &&
+           makeDir(root + "/dev") &&
+           ::mkfifo((root + "/dev/hidraw0").ToCStr(), 0600) == 0;
+}
+
+static void removeTree(const String& root)
+{
+    String command = String("rm -rf '") + root + "'";
+    if (system(command.ToCStr()) != 0)
+        printf("Could not remove %s\n", root.ToCStr());
+}
+
+
+class FrameCounter : public MessageHandler
+{
+public:
+    FrameCounter() : Frames(0) { }
+    ~FrameCounter() { RemoveHandlerFromDevices(); }
+
+    virtual void OnMessage(const Message& msg)
+    {
+        if (msg.Type == Message_BodyFrame)
+            Frames++;
+    }
+
+    volatile int Frames;
+};
+
+static void testTracker(const String& root)
+{
+    Ptr<DeviceManager> manager = *DeviceManager::Create();
+    check(manager, "DeviceManager::Create");
+    if (!manager)
+        return;
+
+    DeviceEnumerator<SensorDevice> e = manager->EnumerateDevices<SensorDevice>();
+    check(e.IsAvailable(), "the fake tracker is enumerated");
+    if (!e.IsAvailable())
+        return;
+
+    SensorInfo info;
+    check(e.GetDeviceInfo(&info), "GetDeviceInfo");
+    check(info.VendorId == 0x2833 && info.ProductId == 0x0001, "vendor and product from uevent");
+    check(!strcmp(info.SerialNumber, "FAKE0001"), "serial number from the USB device");
+
+    Ptr<SensorDevice> sensor = *e.CreateDevice();
+    check(sensor, "the tracker opens through <root>/dev/hidraw0");
+    if (!sensor)
+        return;
+
+    FrameCounter counter;
+    sensor->SetMessageHandler(&counter);
+
+    // Feed tracker reports into the node, one at a time so that each read gets one.
+    int fd = ::open((root + "/dev/hidraw0").ToCStr(), O_WRONLY | O_NONBLOCK);
+    check(fd >= 0, "open the FIFO for writing");
+    for (int i = 0; fd >= 0 && i < 5; i++)
+    {
+        UByte report[62];
+        memset(report, 0, sizeof(report));
+        report[0] = 1;          // TrackerMessage_Sensors
+        report[1] = 1;          // SampleCount
+        report[2] = (UByte)i;   // Timestamp, in ms
+        check(::write(fd, report, sizeof(report)) == (ssize_t)sizeof(report), "write a report");
+        Thread::MSleep(20);
+    }
+    if (fd >= 0)
+        ::close(fd);
+
+    check(counter.Frames > 0, "reports written to the node reach the handler");
+    sensor->SetMessageHandler(0);
+}
+
+
+int main()
+{
+    char rootTemplate[] = "/tmp/ovr-hidraw-XXXXXX";
+    if (!mkdtemp(rootTemplate))
+    {
+        printf("mkdtemp failed\n");
+        return 1;
+    }
+
+    // Read when the HID manager is created.
+    setenv("OVR_HIDRAW_ROOT", rootTemplate, 1);
+
+    System::Init(Log::ConfigureDefaultLog(LogMask_None));
+    {
+        String root(rootTemplate);
+
+        if (buildTree(root))
+            testTracker(root);
+        else
+            check(false, "build the fake tree");
+
+        removeTree(root);
+    }
+    System::Destroy();
+
+    if (Failures)
+        return 1;
+    printf("OK\n");
+    return 0;
+}
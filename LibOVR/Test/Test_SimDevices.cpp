@@ -0,0 +1,328 @@
+/************************************************************************************
+
+Filename    :   Test_SimDevices.cpp
+Content     :   Drives SensorDevice, SensorFusion and LatencyTestDevice through
+                simulated trackers and latency testers on a Sim::DeviceManager.
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Use of this software is subject to the terms of the Oculus license
+agreement provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+*************************************************************************************/
+
+#include "OVR.h"
+#include "OVR_Sim_DeviceManager.h"
+#include "OVR_Sim_HIDDevice.h"
+
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace OVR;
+
+// Counts are checked against generous bounds, since the manager thread may be
+// held up on a loaded machine; the simulated streams themselves don't drift.
+
+static int Failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what);
+        Failures++;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Handlers
+
+// Counts what a device or the manager sends. Message delivery happens on the
+// manager thread, so counts are read under the handler lock; a fusion delegate
+// is called under the fusion's own lock instead, so Get only orders its reads.
+class MessageCounter : public MessageHandler
+{
+public:
+    MessageCounter()
+        : Frames(0), Batches(0), Added(0), Removed(0), TestStarted(0), ColorDetected(0),
+          Elapsed(0), Gaps(0), TimeDeltas(0), pFusion(0), StaleStates(0) { }
+    ~MessageCounter() { RemoveHandlerFromDevices(); }
+
+    virtual void OnMessage(const Message& msg)
+    {
+        switch (msg.Type)
+        {
+        case Message_BodyFrame:
+            {
+                const MessageBodyFrame& frame = static_cast<const MessageBodyFrame&>(msg);
+                Frames++;
+                TimeDeltas += frame.TimeDelta;
+                if (frame.TimeDelta > 0.0015f)
+                    Gaps++;
+                // As a fusion delegate, the state must already include this frame.
+                if (pFusion && (pFusion->GetState().Time != frame.AbsoluteTimeSeconds))
+                    StaleStates++;
+            }
+            break;
+        case Message_BodyFrameBatch:        Batches++;          break;
+        case Message_DeviceAdded:           Added++;            break;
+        case Message_DeviceRemoved:         Removed++;          break;
+        case Message_LatencyTestStarted:    TestStarted++;      break;
+        case Message_LatencyTestColorDetected:
+            ColorDetected++;
+            Elapsed = static_cast<const MessageLatencyTestColorDetected&>(msg).Elapsed;
+            break;
+        default:
+            break;
+        }
+    }
+
+    int Get(const int& count)
+    {
+        Lock::Locker lockScope(GetHandlerLock());
+        return count;
+    }
+
+    int           Frames, Batches, Added, Removed, TestStarted, ColorDetected;
+    int           Elapsed;
+    int           Gaps;
+    double        TimeDeltas;
+    SensorFusion* pFusion;
+    int           StaleStates;
+};
+
+// Opens a simulated tracker's HID device without a SensorDevice, so that nothing
+// renews its keep-alive. Its members run on the manager thread, as for the
+// backends' own HID devices.
+class RawTracker : public RefCountBase<RawTracker>, public OVR::HIDDevice::HIDHandler
+{
+public:
+    RawTracker(Sim::DeviceManager* manager) : pManager(manager), Reports(0) { }
+
+    bool Open(const String* path)
+    {
+        pDevice = *pManager->GetHIDDeviceManager()->Open(*path);
+        if (pDevice)
+            pDevice->SetHandler(this);
+        return pDevice != 0;
+    }
+
+    bool Close()
+    {
+        if (pDevice)
+            pDevice->SetHandler(0);
+        pDevice.Clear();
+        return true;
+    }
+
+    bool SetKeepAlive(UInt16 intervalMs)
+    {
+        UByte keepAlive[5] = { 8, 0, 0, UByte(intervalMs & 0xFF), UByte(intervalMs >> 8) };
+        return pDevice && pDevice->SetFeatureReport(keepAlive, sizeof(keepAlive));
+    }
+
+    virtual void OnInputReport(UByte*, UInt32) { Reports++; }
+
+    int GetReports() { return Reports; }
+
+    Sim::DeviceManager*   pManager;
+    Ptr<OVR::HIDDevice>   pDevice;
+    volatile int          Reports;
+};
+
+
+//-------------------------------------------------------------------------------------
+// ***** Tests
+
+// A tracker added to the manager is found, opened and fused like real hardware,
+// and a fusion delegate sees each frame once fusion has processed it.
+static void testFusion(Sim::DeviceManager* manager, MessageCounter& managerMessages)
+{
+    int addedBefore = managerMessages.Get(managerMessages.Added);
+
+    Sim::HIDDeviceConfig config;
+    config.SerialNumber = "SIMFUSION";
+    String path = manager->AddDevice(config);
+    check(!path.IsEmpty(), "AddDevice returns the tracker's path");
+    check(managerMessages.Get(managerMessages.Added) == addedBefore + 1,
+          "the manager reports the new tracker");
+
+    Ptr<SensorDevice> sensor;
+    for (DeviceEnumerator<SensorDevice> e = manager->EnumerateDevices<SensorDevice>(); e; e.Next())
+    {
+        SensorInfo info;
+        if (e.GetDeviceInfo(&info) && !strcmp(info.SerialNumber, "SIMFUSION"))
+            sensor = *e.CreateDevice();
+    }
+    check(sensor, "the simulated tracker opens as a SensorDevice");
+    if (!sensor)
+        return;
+    check(sensor->GetReportRate() == 500, "SensorDevice sets the 500 Hz default rate");
+
+    SensorFusion   fusion;
+    MessageCounter delegate;
+    delegate.pFusion = &fusion;
+    fusion.AttachToSensor(sensor);
+    fusion.SetDelegateMessageHandler(&delegate);
+
+    Thread::MSleep(500);
+
+    // Two samples per report at 500 Hz.
+    int frames  = delegate.Get(delegate.Frames);
+    int batches = delegate.Get(delegate.Batches);
+    check(frames > 100, "fusion passes frames to its delegate");
+    check(batches > 50 && frames >= 2 * batches - 2, "frames arrive two to a report");
+    check(delegate.Get(delegate.StaleStates) == 0, "the delegate sees the state as of each frame");
+    check(delegate.Get(delegate.Gaps) == 0, "no samples are lost without drops");
+    check(fusion.GetOrientation().w < 0.9999f, "the synthetic yaw turns the orientation");
+
+    // Unplugging stops the stream; plugging the same tracker back in resumes it.
+    check(manager->RemoveDevice(path), "RemoveDevice");
+    Thread::MSleep(50);
+    check(managerMessages.Get(managerMessages.Removed) > 0, "the manager reports the removal");
+    frames = delegate.Get(delegate.Frames);
+    Thread::MSleep(100);
+    check(delegate.Get(delegate.Frames) == frames, "no frames after unplugging");
+
+    path = manager->AddDevice(config);
+    Thread::MSleep(200);
+    check(delegate.Get(delegate.Frames) > frames, "frames resume after plugging back in");
+
+    fusion.SetDelegateMessageHandler(0);
+    fusion.AttachToSensor(0);
+    manager->RemoveDevice(path);
+}
+
+// Dropped reports show up as frames standing in for the missed samples, and
+// jitter delays reports without losing any.
+static void testDropsAndJitter(Sim::DeviceManager* manager)
+{
+    Sim::HIDDeviceConfig config;
+    config.SerialNumber = "SIMDROPS";
+    config.ReportRateHz = 1000;
+    config.DropRate     = 0.5f;
+    config.JitterMks    = 500;
+    config.Seed         = 7;
+    String path = manager->AddDevice(config);
+
+    Ptr<SensorDevice> sensor;
+    for (DeviceEnumerator<SensorDevice> e = manager->EnumerateDevices<SensorDevice>(); e; e.Next())
+    {
+        SensorInfo info;
+        if (e.GetDeviceInfo(&info) && !strcmp(info.SerialNumber, "SIMDROPS"))
+            sensor = *e.CreateDevice();
+    }
+    check(sensor, "the lossy tracker opens");
+    if (!sensor)
+        return;
+
+    MessageCounter counter;
+    sensor->SetMessageHandler(&counter);
+    Thread::MSleep(500);
+    sensor->SetMessageHandler(0);
+
+    // Each delivered report carries one sample, preceded by one frame standing
+    // in for the samples of the reports dropped before it.
+    int    batches    = counter.Batches;
+    int    gaps       = counter.Frames - batches;
+    double perReport  = (batches > 0) ? counter.TimeDeltas / batches : 0;
+    check(batches > 50, "reports arrive despite drops and jitter");
+    check(gaps > batches / 4 && gaps < batches, "dropped reports leave gaps");
+    check(perReport > 0.0015 && perReport < 0.0025, "gap frames cover the dropped half of the samples");
+
+    manager->RemoveDevice(path);
+}
+
+// A tracker stops reporting once its keep-alive interval passes without a
+// new keep-alive, and starts again when one arrives.
+static void testKeepAlive(Sim::DeviceManager* manager)
+{
+    Sim::HIDDeviceConfig config;
+    config.SerialNumber = "SIMKEEPALIVE";
+    config.ReportRateHz = 1000;
+    String path = manager->AddDevice(config);
+
+    Ptr<RawTracker> tracker = *new RawTracker(manager);
+    bool ok = false;
+    manager->pThread->PushCallAndWaitResult(tracker.GetPtr(), &RawTracker::Open, &ok, &path);
+    check(ok, "open the tracker's HID device");
+    if (!ok)
+        return;
+
+    manager->pThread->PushCallAndWaitResult(tracker.GetPtr(), &RawTracker::SetKeepAlive, &ok, UInt16(100));
+    check(ok, "set a 100 ms keep-alive");
+
+    Thread::MSleep(300);
+    int reports = tracker->GetReports();
+    check(reports > 20, "reports arrive until the keep-alive expires");
+    Thread::MSleep(100);
+    check(tracker->GetReports() == reports, "no reports once the keep-alive has expired");
+
+    manager->pThread->PushCallAndWaitResult(tracker.GetPtr(), &RawTracker::SetKeepAlive, &ok, UInt16(1000));
+    Thread::MSleep(100);
+    check(tracker->GetReports() > reports, "a new keep-alive restarts the reports");
+
+    manager->pThread->PushCallAndWaitResult(tracker.GetPtr(), &RawTracker::Close, &ok);
+    manager->RemoveDevice(path);
+}
+
+// StartTest is answered by Message_LatencyTestStarted and, after the configured
+// latency, by Message_LatencyTestColorDetected with the elapsed time in ms.
+static void testLatencyTester(Sim::DeviceManager* manager)
+{
+    Sim::HIDDeviceConfig config(Sim::HIDDeviceConfig::Device_LatencyTester);
+    config.LatencyMks = 50 * Timer::MksPerMs;
+    String path = manager->AddDevice(config);
+
+    Ptr<LatencyTestDevice> tester = *manager->EnumerateDevices<LatencyTestDevice>().CreateDevice();
+    check(tester, "the simulated latency tester opens");
+    if (!tester)
+        return;
+
+    MessageCounter counter;
+    tester->SetMessageHandler(&counter);
+    check(tester->SetStartTest(Color(255, 0, 0)), "SetStartTest");
+    Thread::MSleep(200);
+
+    check(counter.Get(counter.TestStarted) == 1, "the test start is reported");
+    check(counter.Get(counter.ColorDetected) == 1, "the color change is reported");
+    check(counter.Get(counter.Elapsed) == 50, "the elapsed time is the configured latency");
+
+    tester->SetMessageHandler(0);
+    manager->RemoveDevice(path);
+}
+
+
+int main()
+{
+    System::Init(Log::ConfigureDefaultLog(LogMask_None));
+    {
+        Ptr<Sim::DeviceManager> manager = *Sim::DeviceManager::Create();
+        check(manager, "Sim::DeviceManager::Create");
+
+        if (manager)
+        {
+            MessageCounter managerMessages;
+            manager->SetMessageHandler(&managerMessages);
+
+            testFusion(manager, managerMessages);
+            testDropsAndJitter(manager);
+            testKeepAlive(manager);
+            testLatencyTester(manager);
+
+            manager->SetMessageHandler(0);
+        }
+    }
+    System::Destroy();
+
+    if (Failures)
+        return 1;
+    printf("OK\n");
+    return 0;
+}
@@ -13,6 +13,7 @@
 #include <assert.h>
 
 #include <libovr_nsb/OVR.h>
+#include <gl_matrix/gl_matrixf.h>
 
 #include "gltools.h"
 #include "glstereo.h"
@@ -46,13 +47,6 @@ void printOGLError( char *file, int line )
         printf( "glError in file %s, line %d: %s (0x%08x)\n", file, line, gluErrorString(err), err );
 }
 
-// convert to OpenGL float matrix, from gl-matrix.c double
-void oglMatrix( mat4_t m, float *f )
-{
-    int i;
-    for( i=0;i<16;i++ ) f[i] = m[i];
-}
-
 // Elapsed time since glutInit(), in seconds
 float simtime()
 {
@@ -467,17 +461,16 @@ static void skyRender( float *mtx, float time, GLuint shader )
 void render( mat4_t view, mat4_t proj, void *data )
 {
     RList *r = g_renderList;
-    double dMtx[16];
-    float  fMtx[16];
+    mat4f fView = mat4f_load( view );
+    mat4f fProj = mat4f_load( proj );
+    mat4f mv, mvp;
     GLint u_mvp;
     GLint u_mv;
     GLuint prog = 0;
 
     // Skysphere
-    mat4_multiply( proj, view, dMtx );
-    mat4_inverse( dMtx, NULL );
-    oglMatrix( dMtx, fMtx );
-    skyRender( fMtx, simtime(), g_skyshader );
+    mvp = mat4f_inverse( mat4f_multiply( fProj, fView ), NULL );
+    skyRender( mvp.m, simtime(), g_skyshader );
 
     // Scene
     while( r )
@@ -492,13 +485,11 @@ void render( mat4_t view, mat4_t proj, void *data )
             u_mv  = glGetUniformLocation( prog, "modelViewMtx" );
         }
 
-        mat4_multiply( view, r->mtx, dMtx );
-        oglMatrix( dMtx, fMtx );
-        glUniformMatrix4fv( u_mv, 1, GL_FALSE, fMtx );
+        mv = mat4f_multiply( fView, mat4f_load( r->mtx ) );
+        glUniformMatrix4fv( u_mv, 1, GL_FALSE, mv.m );
 
-        mat4_multiply( proj, dMtx, dMtx );
-        oglMatrix( dMtx, fMtx );
-        glUniformMatrix4fv( u_mvp, 1, GL_FALSE, fMtx );
+        mvp = mat4f_multiply( fProj, mv );
+        glUniformMatrix4fv( u_mvp, 1, GL_FALSE, mvp.m );
 
         renderObj( r->rend );
 
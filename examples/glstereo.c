@@ -9,6 +9,8 @@
  *
  */
 
+#include <assert.h>
+
 #include "glstereo.h"
 
 /* TODO
@@ -448,6 +450,9 @@ void glStereoRender( GLStereo *sr, double pos[3], render_fn render )
     double eye[16];
     View *bb = &sr->backbuffer;
     View *fb = &sr->framebuffer;
+#ifdef OVR_ASSERT_NO_ALLOC
+    unsigned long allocs = gl_matrix_allocCount();
+#endif
 
     if( !bb->offscreen || !fboBind(bb->fbo) )
     {
@@ -524,6 +529,10 @@ void glStereoRender( GLStereo *sr, double pos[3], render_fn render )
     distort.XCenterOffset = -distort.XCenterOffset;
     mapDistortion( sr, bb->rgba, &distort, &v, fb );
 
+#ifdef OVR_ASSERT_NO_ALLOC
+    // The per-frame math, including the caller's render, must not allocate
+    assert( gl_matrix_allocCount() == allocs );
+#endif
 }
 
 void glStereoRenderMono( GLStereo *sr, double pos[3], render_fn render )
@@ -0,0 +1,446 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <libovr_nsb/OVR.h>
+
+// gl_matrix benchmark.  Times the batch quaternion functions on every
+// kernel set this CPU supports against a loop of the single-quaternion
+// calls, and checks that each gives the loop's results exactly.  Checks
+// that the mat4 kernels of every kernel set give the scalar results bit
+// for bit, and times them.  Then compares the small-angle trig used by
+// sensor fusion with libm.  Exits with 1 if any result differs.
+
+static const char *g_paths[] = { "scalar", "sse2", "neon", "avx", 0 };
+
+unsigned int g_count = 1024;
+unsigned int g_iters = 2000;
+unsigned int g_mismatches = 0;
+
+typedef struct
+{
+    double      *Mem;
+    quat_soa_t  A, B, D;
+    vec3_soa_t  V, VD;
+    double      *T;
+
+    // The same data, one quaternion/vector per element
+    double      *QA, *QB, *QD, *VA, *VDA;
+} BenchData;
+
+static double randUnit( )
+{
+    return rand() / (double)RAND_MAX * 2.0 - 1.0;
+}
+
+void initBenchData( BenchData *b, unsigned int n )
+{
+    double *p = b->Mem = (double *)calloc(n * 41, sizeof(double));
+    unsigned int i;
+
+    b->A.x = p;  b->A.y = p += n; b->A.z = p += n; b->A.w = p += n;
+    b->B.x = p += n; b->B.y = p += n; b->B.z = p += n; b->B.w = p += n;
+    b->D.x = p += n; b->D.y = p += n; b->D.z = p += n; b->D.w = p += n;
+    b->V.x = p += n; b->V.y = p += n; b->V.z = p += n;
+    b->VD.x = p += n; b->VD.y = p += n; b->VD.z = p += n;
+    b->T = p += n;
+    b->QA = p += n; b->QB = p += 4 * n; b->QD = p += 4 * n;
+    b->VA = p += 4 * n; b->VDA = p += 3 * n;
+
+    for( i = 0; i < n; i++ )
+    {
+        double q[4] = { randUnit(), randUnit(), randUnit(), randUnit() };
+        double r[4] = { randUnit(), randUnit(), randUnit(), randUnit() };
+        quat_normalize(q, 0);
+        quat_normalize(r, 0);
+        if( i % 8 == 0 )
+        {
+            // Nearly equal neighbours exercise slerp's linear fallback
+            quat_set(q, r);
+            r[0] += 1e-7;
+        }
+
+        b->A.x[i] = b->QA[i*4]   = q[0];
+        b->A.y[i] = b->QA[i*4+1] = q[1];
+        b->A.z[i] = b->QA[i*4+2] = q[2];
+        b->A.w[i] = b->QA[i*4+3] = q[3];
+        b->B.x[i] = b->QB[i*4]   = r[0];
+        b->B.y[i] = b->QB[i*4+1] = r[1];
+        b->B.z[i] = b->QB[i*4+2] = r[2];
+        b->B.w[i] = b->QB[i*4+3] = r[3];
+        b->V.x[i] = b->VA[i*3]   = randUnit() * 10;
+        b->V.y[i] = b->VA[i*3+1] = randUnit() * 10;
+        b->V.z[i] = b->VA[i*3+2] = randUnit() * 10;
+        b->T[i] = (i % 16) / 15.0;
+    }
+}
+
+static int compareQuats( BenchData *b )
+{
+    unsigned int i, bad = 0;
+    for( i = 0; i < g_count; i++ )
+    {
+        double d[4] = { b->D.x[i], b->D.y[i], b->D.z[i], b->D.w[i] };
+        if( memcmp(d, b->QD + i*4, sizeof(d)) )
+            bad++;
+    }
+    return bad;
+}
+
+static int compareVecs( BenchData *b )
+{
+    unsigned int i, bad = 0;
+    for( i = 0; i < g_count; i++ )
+    {
+        double d[3] = { b->VD.x[i], b->VD.y[i], b->VD.z[i] };
+        if( memcmp(d, b->VDA + i*3, sizeof(d)) )
+            bad++;
+    }
+    return bad;
+}
+
+static void report( const char *what, double loopTime, double batchTime, int bad )
+{
+    double n = (double)g_count * g_iters;
+    g_mismatches += bad;
+    printf("\t%-20s loop %7.2fns  batch %7.2fns  x%-5.2f %s\n", what,
+           loopTime / n * 1e9, batchTime / n * 1e9, loopTime / batchTime,
+           bad ? "MISMATCH" : "exact" );
+}
+
+void benchQuats( BenchData *b )
+{
+    unsigned int i, it;
+    double start, loopTime;
+
+    // quat_multiply
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        for( i = 0; i < g_count; i++ )
+            quat_multiply(b->QA + i*4, b->QB + i*4, b->QD + i*4);
+    loopTime = getHostTime() - start;
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        quat_multiply_n(&b->A, &b->B, &b->D, g_count);
+    report("quat_multiply_n", loopTime, getHostTime() - start, compareQuats(b));
+
+    // quat_normalize
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        for( i = 0; i < g_count; i++ )
+            quat_normalize(b->QB + i*4, b->QD + i*4);
+    loopTime = getHostTime() - start;
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        quat_normalize_n(&b->B, &b->D, g_count);
+    report("quat_normalize_n", loopTime, getHostTime() - start, compareQuats(b));
+
+    // quat_slerp
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        for( i = 0; i < g_count; i++ )
+            quat_slerp(b->QA + i*4, b->QB + i*4, b->T[i], b->QD + i*4);
+    loopTime = getHostTime() - start;
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        quat_slerp_n(&b->A, &b->B, b->T, &b->D, g_count);
+    report("quat_slerp_n", loopTime, getHostTime() - start, compareQuats(b));
+
+    // quat_multiplyVec3
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        for( i = 0; i < g_count; i++ )
+            quat_multiplyVec3(b->QA + i*4, b->VA + i*3, b->VDA + i*3);
+    loopTime = getHostTime() - start;
+    start = getHostTime();
+    for( it = 0; it < g_iters; it++ )
+        quat_rotate_vec3_n(&b->A, &b->V, &b->VD, g_count);
+    report("quat_rotate_vec3_n", loopTime, getHostTime() - start, compareVecs(b));
+}
+
+// Matrices with exact zeros and ones mixed in, and some singular ones:
+// a repeated row, a zero column or all zeros
+static void initMatrices( double *m, unsigned int n )
+{
+    unsigned int i, j;
+    for( i = 0; i < n; i++, m += 16 )
+    {
+        for( j = 0; j < 16; j++ )
+        {
+            unsigned int k = rand() % 8;
+            m[j] = k == 0 ? 0 : k == 1 ? 1 : k == 2 ? -1 : randUnit() * 4;
+        }
+        if( i % 13 == 3 )
+            memcpy(m + 4, m, 4 * sizeof(double));
+        if( i % 17 == 5 )
+            m[2] = m[6] = m[10] = m[14] = 0;
+        if( i % 29 == 7 )
+            memset(m, 0, 16 * sizeof(double));
+    }
+}
+
+// Runs every mat4 kernel on the current kernel set into out: products
+// into a separate dest and in place over either operand, inverses into a
+// separate dest and in place (singular matrices leave NULL in ok),
+// transformed arrays of every length up to 8 and a long one, in place
+// and not.  out must hold 128 * n + 3 * (n + 36) * 2 doubles.
+static void runMat4( const double *a, const double *b, const double *v,
+                     unsigned int n, double *out, unsigned char *ok )
+{
+    double *mul = out, *mulA = mul + 16 * n, *mulB = mulA + 16 * n;
+    double *inv = mulB + 16 * n, *invIn = inv + 16 * n;
+    double *xf = invIn + 16 * n, *xfIn = xf + 3 * (n + 36);
+    unsigned int i, len;
+
+    for( i = 0; i < n; i++ )
+    {
+        double *d;
+
+        mat4_multiply((mat4_t)a + 16*i, (mat4_t)b + 16*i, mul + 16*i);
+
+        d = mulA + 16*i;
+        memcpy(d, a + 16*i, 16 * sizeof(double));
+        mat4_multiply(d, (mat4_t)b + 16*i, NULL);
+
+        d = mulB + 16*i;
+        memcpy(d, b + 16*i, 16 * sizeof(double));
+        mat4_multiply((mat4_t)a + 16*i, d, d);
+
+        // A failed inverse must leave dest alone on every path
+        memset(inv + 16*i, 0, 16 * sizeof(double));
+        ok[2*i] = mat4_inverse((mat4_t)a + 16*i, inv + 16*i) != NULL;
+
+        d = invIn + 16*i;
+        memcpy(d, a + 16*i, 16 * sizeof(double));
+        ok[2*i+1] = mat4_inverse(d, NULL) != NULL;
+    }
+
+    // Lengths 0..8 cover every remainder a vector loop can leave
+    memcpy(xfIn, v, 3 * (n + 36) * sizeof(double));
+    for( len = 0; len <= 8; len++ )
+    {
+        mat4_transformVec3Array((mat4_t)a, (vec3_t)v + 3 * len * len / 2, len, xf + 3 * len * len / 2);
+        mat4_transformVec3Array((mat4_t)a, xfIn + 3 * len * len / 2, len, NULL);
+    }
+    mat4_transformVec3Array((mat4_t)b, (vec3_t)v + 3 * 36, n, xf + 3 * 36);
+    mat4_transformVec3Array((mat4_t)b, xfIn + 3 * 36, n, NULL);
+}
+
+void checkMat4( BenchData *b )
+{
+    unsigned int n = g_count, size = 128 * n + 6 * (n + 36);
+    unsigned int i, it, j;
+    double *ma = (double *)malloc(16 * n * sizeof(double));
+    double *mb = (double *)malloc(16 * n * sizeof(double));
+    double *v = (double *)malloc(3 * (n + 36) * sizeof(double));
+    double *ref = (double *)malloc(size * sizeof(double));
+    double *out = (double *)malloc(size * sizeof(double));
+    unsigned char *refOk = (unsigned char *)malloc(2 * n);
+    unsigned char *outOk = (unsigned char *)malloc(2 * n);
+    double start;
+
+    initMatrices(ma, n);
+    initMatrices(mb, n);
+    for( i = 0; i < 3 * (n + 36); i++ )
+        v[i] = randUnit() * 10;
+
+    gl_matrix_setSimdPath("scalar");
+    runMat4(ma, mb, v, n, ref, refOk);
+
+    printf("mat4 kernels vs scalar, %u matrices:\n", n);
+    for( j = 0; g_paths[j]; j++ )
+    {
+        static const char *parts[] = { "multiply", "multiply dest=mat", "multiply dest=mat2",
+                                       "inverse", "inverse in place", "transformVec3Array",
+                                       "transform in place" };
+        unsigned int offsets[] = { 0, 16*n, 32*n, 48*n, 64*n, 80*n, 80*n + 3*(n + 36), size };
+        unsigned int bad[7] = { 0 }, p, total = 0;
+
+        if( !gl_matrix_setSimdPath(g_paths[j]) )
+            continue;
+
+        memset(out, 0, size * sizeof(double));
+        runMat4(ma, mb, v, n, out, outOk);
+
+        for( p = 0; p < 7; p++ )
+            for( i = offsets[p]; i < offsets[p+1]; i++ )
+                if( memcmp(out + i, ref + i, sizeof(double)) )
+                    bad[p]++;
+        for( i = 0; i < 2 * n; i++ )
+            if( outOk[i] != refOk[i] )
+                bad[3 + (i & 1)]++;
+
+        printf("%s\n", g_paths[j]);
+        for( p = 0; p < 7; p++ )
+        {
+            total += bad[p];
+            if( bad[p] )
+                printf("\t%-20s MISMATCH in %u values\n", parts[p], bad[p]);
+        }
+        if( !total )
+            printf("\tall mat4 results exact\n");
+        g_mismatches += total;
+
+        // Per-call timings
+        start = getHostTime();
+        for( it = 0; it < g_iters; it++ )
+            for( i = 0; i < n; i++ )
+                mat4_multiply(ma + 16*i, mb + 16*i, out + 16*i);
+        printf("\t%-20s %7.2fns\n", "mat4_multiply",
+               (getHostTime() - start) / ((double)n * g_iters) * 1e9);
+        start = getHostTime();
+        for( it = 0; it < g_iters; it++ )
+            for( i = 0; i < n; i++ )
+                mat4_inverse(mb + 16*i, out + 16*i);
+        printf("\t%-20s %7.2fns\n", "mat4_inverse",
+               (getHostTime() - start) / ((double)n * g_iters) * 1e9);
+        start = getHostTime();
+        for( it = 0; it < g_iters; it++ )
+            mat4_transformVec3Array(ma, v, n, out);
+        printf("\t%-20s %7.2fns per vector\n", "transformVec3Array",
+               (getHostTime() - start) / ((double)n * g_iters) * 1e9);
+    }
+    gl_matrix_setSimdPath(NULL);
+
+    free(ma); free(mb); free(v); free(ref); free(out); free(refOk); free(outOk);
+    (void)b;
+}
+
+// Distance between two doubles in units in the last place
+static double ulps( double a, double b )
+{
+    if( a == b )
+        return 0;
+    return fabs(a - b) / (nextafter(fabs(b), INFINITY) - fabs(b));
+}
+
+void benchTrig( BenchData *b )
+{
+    unsigned int i, it, n = g_count * g_iters;
+    double start, libmTime, fastTime, s, c, sum = 0;
+    double maxSin = 0, maxCos = 0, maxSinUlp = 0, maxCosUlp = 0;
+
+    // Accuracy over the whole polynomial range
+    for( i = 0; i <= 100000; i++ )
+    {
+        double x = SMALL_ANGLE_MAX * i / 100000;
+        smallAngleSinCos(x, &s, &c);
+        maxSin = fmax(maxSin, fabs(s - sin(x)));
+        maxCos = fmax(maxCos, fabs(c - cos(x)));
+        maxSinUlp = fmax(maxSinUlp, ulps(s, sin(x)));
+        maxCosUlp = fmax(maxCosUlp, ulps(c, cos(x)));
+    }
+    printf("smallAngleSinCos on [0, %g]: sin err %.2g (%.1f ulp), cos err %.2g (%.1f ulp)\n",
+           SMALL_ANGLE_MAX, maxSin, maxSinUlp, maxCos, maxCosUlp);
+
+    // Gyro-sized steps: ~1ms samples at up to a few rad/s
+    start = getHostTime();
+    for( i = 0; i < n; i++ )
+    {
+        double x = (i & 1023) * 1e-5;
+        sum += sin(x) + cos(x);
+    }
+    libmTime = getHostTime() - start;
+    start = getHostTime();
+    for( i = 0; i < n; i++ )
+    {
+        double x = (i & 1023) * 1e-5;
+        smallAngleSinCos(x, &s, &c);
+        sum += s + c;
+    }
+    fastTime = getHostTime() - start;
+    printf("\t%-20s libm %7.2fns  fast  %7.2fns  x%.2f\n", "sin+cos",
+           libmTime / n * 1e9, fastTime / n * 1e9, libmTime / fastTime);
+
+    // Angle comparisons, as in the tilt correction
+    {
+        double up[3] = { 0, 1, 0 };
+        unsigned int disagree = 0;
+
+        for( i = 0; i + 1 < g_count; i++ )
+        {
+            double *v1 = b->VA + i*3, *v2 = v1 + 3;
+            if( (vec3_angle(up, v1) < vec3_angle(up, v2)) != (vec3_angleKey(up, v1) < vec3_angleKey(up, v2)) )
+                disagree++;
+        }
+
+        start = getHostTime();
+        for( it = 0; it < g_iters; it++ )
+            for( i = 0; i < g_count; i++ )
+                sum += vec3_angle(up, b->VA + i*3);
+        libmTime = getHostTime() - start;
+        start = getHostTime();
+        for( it = 0; it < g_iters; it++ )
+            for( i = 0; i < g_count; i++ )
+                sum += vec3_angleKey(up, b->VA + i*3);
+        fastTime = getHostTime() - start;
+        printf("\t%-20s angle %7.2fns  key   %7.2fns  x%-5.2f %s\n", "vec3_angleKey",
+               libmTime / n * 1e9, fastTime / n * 1e9, libmTime / fastTime,
+               disagree ? "ORDER MISMATCH" : "same order" );
+    }
+
+    // Keep the timed loops from being optimized away
+    if( sum == 42 )
+        printf("\n");
+}
+
+void usage( char *progname ){
+    printf("\n");
+    printf("%s [options]\n", progname );
+    printf("Options:\n");
+    printf(" --count <n>       -quaternions per batch (default %u)\n", g_count );
+    printf(" --iters <n>       -batches timed per function (default %u)\n", g_iters );
+    printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+// Name: main( )
+// Desc: entry point
+//-----------------------------------------------------------------------------
+int main( int argc, char ** argv )
+{
+    BenchData data;
+    int i;
+
+    char *progname = argv[0];
+    while( argc > 1 )
+    {
+        if( !strncmp( argv[1],"--count",7 ) && argc > 2 ){
+            g_count = atoi( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--iters",7 ) && argc > 2 ){
+            g_iters = atoi( argv[2] );
+            argv++; argc--;
+        }else{
+            if( strncmp( argv[1],"--help",6 ) )
+                printf( "Unrecognized option: %s\n", argv[1] );
+            usage( progname );
+            exit(1);
+        }
+        argv++; argc--;
+    }
+
+    initBenchData(&data, g_count);
+    printf("%u quaternions x %u batches, per element:\n", g_count, g_iters);
+
+    for( i = 0; g_paths[i]; i++ )
+    {
+        if( !gl_matrix_setSimdPath(g_paths[i]) )
+            continue;
+        printf("%s\n", g_paths[i]);
+        benchQuats(&data);
+    }
+
+    checkMat4(&data);
+    benchTrig(&data);
+
+    free(data.Mem);
+    if( g_mismatches )
+    {
+        printf("%u results differ from the scalar code\n", g_mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+
+#include <libovr_nsb/OVR.h>
+
+// Pose server: owns the Rift and publishes every fused sample to shared
+// memory, so any number of processes can read tracking with openPoseShm()
+// and getPose().
+
+static volatile int g_running = 1;
+
+void stopFunc( int sig )
+{
+    g_running = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Sample listener - runs for every fused sample
+/////////////////////////////////////////////////////////////////////////////////////
+void publishFunc( struct Device *dev, const struct MessageBodyFrame *msg,
+                  const double *Q, void *userData )
+{
+    PoseShm *shm = (PoseShm *)userData;
+    publishPoseShm(shm, getHostTime(), dev->Q, dev->AngV);
+}
+
+void usage( char *progname ){
+    printf("\n");
+    printf("%s [options]\n", progname );
+    printf("Options:\n");
+    printf(" --device <n>      -which Rift to open (default 0)\n");
+    printf(" --name <shmname>  -shared memory object (default %s)\n", POSE_SHM_DEFAULT_NAME );
+    printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+// Name: main( )
+// Desc: entry point
+//-----------------------------------------------------------------------------
+int main( int argc, char ** argv )
+{
+    int nthDevice = 0;
+    const char *shmName = POSE_SHM_DEFAULT_NAME;
+    PoseShm shm;
+
+    char *progname = argv[0];
+    while( argc > 1 )
+    {
+        if( !strncmp( argv[1],"--device",8 ) && argc > 2 ){
+            nthDevice = atoi( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--name",6 ) && argc > 2 ){
+            shmName = argv[2];
+            argv++; argc--;
+        }else{
+            if( strncmp( argv[1],"--help",6 ) )
+                printf( "Unrecognized option: %s\n", argv[1] );
+            usage( progname );
+            exit(1);
+        }
+        argv++; argc--;
+    }
+
+    Device *dev = openRift(nthDevice,0);
+    if( !dev )
+    {
+        printf("Could not locate Rift\n");
+        printf("Be sure you have read/write permission to the proper /dev/hidrawX device\n");
+        return -1;
+    }
+
+    if( !createPoseShm(&shm, shmName) )
+    {
+        printf("Could not create shared memory object %s: %s\n", shmName, strerror(errno));
+        closeRift(dev);
+        free(dev);
+        return -1;
+    }
+
+    signal(SIGINT, stopFunc);
+    signal(SIGTERM, stopFunc);
+
+    addSampleListener(dev, publishFunc, &shm);
+
+    printf("Publishing poses to %s\n", shmName);
+    printf("CTRL-C to quit\n\n");
+
+    sendSensorKeepAlive(dev);
+    double nextKeepAlive = getHostTime() + dev->keepAliveIntervalMs * 0.0005;
+
+    while( g_running )
+    {
+        waitSampleDevice(dev, 100);
+
+        // Keepalive at half the device's interval
+        double now = getHostTime();
+        if( now >= nextKeepAlive )
+        {
+            sendSensorKeepAlive(dev);
+            nextKeepAlive = now + dev->keepAliveIntervalMs * 0.0005;
+        }
+    }
+
+    closePoseShm(&shm);
+    closeRift(dev);
+    free(dev);
+    return 0;
+}
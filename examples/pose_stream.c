@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+
+#include <libovr_nsb/OVR.h>
+
+// Pose streaming example.
+//   --send   stream the Rift's fused samples
+//   --recv   print received samples with their end-to-end latency
+//   --bench  loopback benchmark: a sender thread streams synthetic poses,
+//            flat out or at --rate, and the receiver reports latency and rates
+
+#define DEFAULT_PORT 7700
+#define RECV_BATCH   (POSE_STREAM_MAX_BATCH * POSE_STREAM_MAX_DATAGRAMS)
+
+const char *g_unixPath = 0;
+UInt16 g_port = DEFAULT_PORT;
+UInt32 g_batch = POSE_STREAM_DEFAULT_BATCH;
+UInt32 g_datagramsPerSend = 1;
+double g_benchSeconds = 5.0;
+double g_benchRate = 0;
+
+volatile int g_benchRunning = 1;
+
+BOOLEAN openSender( PoseStreamSender *s )
+{
+    BOOLEAN ok = g_unixPath ? openPoseStreamUnix(s, g_unixPath, g_batch)
+                            : openPoseStreamUDP(s, "127.0.0.1", g_port, g_batch);
+    s->DatagramsPerSend = g_datagramsPerSend;
+    return ok;
+}
+
+BOOLEAN openReceiver( PoseStreamReceiver *r )
+{
+    return g_unixPath ? bindPoseStreamUnix(r, g_unixPath)
+                      : bindPoseStreamUDP(r, 0, g_port);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Sample listener - queue every fused sample on the stream
+/////////////////////////////////////////////////////////////////////////////////////
+void streamFunc( struct Device *dev, const struct MessageBodyFrame *msg,
+                 const double *Q, void *userData )
+{
+    streamPose((PoseStreamSender *)userData, getHostTime(), dev->Q, dev->AngV);
+}
+
+int runSend( )
+{
+    PoseStreamSender sender;
+
+    Device *dev = openRift(0,0);
+    if( !dev )
+    {
+        printf("Could not locate Rift\n");
+        printf("Be sure you have read/write permission to the proper /dev/hidrawX device\n");
+        return -1;
+    }
+    if( !openSender(&sender) )
+    {
+        printf("Could not open sender: %s\n", strerror(errno));
+        closeRift(dev);
+        free(dev);
+        return -1;
+    }
+
+    addSampleListener(dev, streamFunc, &sender);
+    printf("CTRL-C to quit\n\n");
+
+    sendSensorKeepAlive(dev);
+    double nextKeepAlive = getHostTime() + dev->keepAliveIntervalMs * 0.0005;
+
+    for(;;)
+    {
+        waitSampleDevice(dev, 100);
+
+        // Keepalive at half the device's interval
+        double now = getHostTime();
+        if( now >= nextKeepAlive )
+        {
+            sendSensorKeepAlive(dev);
+            nextKeepAlive = now + dev->keepAliveIntervalMs * 0.0005;
+        }
+    }
+    return 0;
+}
+
+int runRecv( )
+{
+    PoseStreamReceiver recv;
+    PoseSample samples[RECV_BATCH];
+
+    if( !openReceiver(&recv) )
+    {
+        printf("Could not bind receiver: %s\n", strerror(errno));
+        return -1;
+    }
+
+    for(;;)
+    {
+        int n = receivePoses(&recv, samples, RECV_BATCH, -1);
+        if( n < 0 )
+        {
+            break;
+        }
+        if( n > 0 )
+        {
+            PoseSample *p = &samples[n-1];
+            printf("\tQ:%+-10g %+-10g %+-10g %+-10g  latency %.1fus  dropped %llu\n",
+                   p->Q[0], p->Q[1], p->Q[2], p->Q[3],
+                   (getHostTime() - p->Time) * 1e6, recv.SamplesDropped );
+        }
+    }
+    closePoseStreamReceiver(&recv);
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Benchmark sender thread
+/////////////////////////////////////////////////////////////////////////////////////
+void *benchSendFunc( void *data )
+{
+    PoseStreamSender *sender = (PoseStreamSender *)data;
+    double q[4] = { 0, 0, 0, 1 };
+    double angV[3] = { 0, 0, 0 };
+
+    double next = getHostTime();
+
+    while( g_benchRunning )
+    {
+        if( g_benchRate > 0 )
+        {
+            // Spin rather than sleep so pacing doesn't add scheduler latency
+            while( getHostTime() < next )
+                ;
+            next += 1.0 / g_benchRate;
+        }
+        streamPose(sender, getHostTime(), q, angV);
+    }
+    flushPoseStream(sender);
+    return 0;
+}
+
+int runBench( )
+{
+    PoseStreamSender sender;
+    PoseStreamReceiver recv;
+    PoseSample samples[RECV_BATCH];
+    pthread_t thread;
+
+    if( !openReceiver(&recv) )
+    {
+        printf("Could not bind receiver: %s\n", strerror(errno));
+        return -1;
+    }
+    if( !openSender(&sender) )
+    {
+        printf("Could not open sender: %s\n", strerror(errno));
+        closePoseStreamReceiver(&recv);
+        return -1;
+    }
+
+    printf("%s loopback, %lu samples/datagram, %lu datagrams/send, %.0fs\n",
+           g_unixPath ? "Unix" : "UDP", sender.BatchSize, sender.DatagramsPerSend, g_benchSeconds );
+
+    double latencySum = 0, latencyMax = 0;
+    double start = getHostTime();
+    pthread_create(&thread, NULL, benchSendFunc, &sender);
+
+    while( getHostTime() - start < g_benchSeconds )
+    {
+        int n = receivePoses(&recv, samples, RECV_BATCH, 10);
+        double now = getHostTime();
+        int i;
+        for( i = 0; i < n; i++ )
+        {
+            double latency = now - samples[i].Time;
+            latencySum += latency;
+            if( latency > latencyMax )
+                latencyMax = latency;
+        }
+    }
+    g_benchRunning = 0;
+    pthread_join(thread, NULL);
+
+    double elapsed = getHostTime() - start;
+    printf("\tsent:      %llu samples in %llu datagrams (%llu datagrams dropped at sender)\n",
+           sender.SamplesSent, sender.DatagramsSent, sender.SendErrors );
+    printf("\treceived:  %llu samples in %llu datagrams, %llu lost\n",
+           recv.SamplesReceived, recv.DatagramsReceived, recv.SamplesDropped );
+    printf("\trate:      %.0f datagrams/s, %.0f samples/s\n",
+           recv.DatagramsReceived / elapsed, recv.SamplesReceived / elapsed );
+    if( recv.SamplesReceived )
+        printf("\tlatency:   mean %.1fus, max %.1fus\n",
+               latencySum / recv.SamplesReceived * 1e6, latencyMax * 1e6 );
+
+    closePoseStreamSender(&sender);
+    closePoseStreamReceiver(&recv);
+    return 0;
+}
+
+void usage( char *progname ){
+    printf("\n");
+    printf("%s --send|--recv|--bench [options]\n", progname );
+    printf("Options:\n");
+    printf(" --unix <path>     -use a Unix datagram socket instead of UDP\n");
+    printf(" --port <n>        -loopback UDP port (default %d)\n", DEFAULT_PORT );
+    printf(" --batch <n>       -samples per datagram (max %d)\n", POSE_STREAM_MAX_BATCH );
+    printf(" --mmsg <n>        -datagrams per sendmmsg (max %d)\n", POSE_STREAM_MAX_DATAGRAMS );
+    printf(" --time <s>        -benchmark duration\n");
+    printf(" --rate <hz>       -benchmark samples/s (default: as fast as possible)\n");
+    printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+// Name: main( )
+// Desc: entry point
+//-----------------------------------------------------------------------------
+int main( int argc, char ** argv )
+{
+    int mode = 0;
+
+    char *progname = argv[0];
+    while( argc > 1 )
+    {
+        if( !strncmp( argv[1],"--send",6 ) ){
+            mode = 's';
+        }else
+        if( !strncmp( argv[1],"--recv",6 ) ){
+            mode = 'r';
+        }else
+        if( !strncmp( argv[1],"--bench",7 ) ){
+            mode = 'b';
+        }else
+        if( !strncmp( argv[1],"--unix",6 ) && argc > 2 ){
+            g_unixPath = argv[2];
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--port",6 ) && argc > 2 ){
+            g_port = atoi( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--batch",7 ) && argc > 2 ){
+            g_batch = atoi( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--mmsg",6 ) && argc > 2 ){
+            g_datagramsPerSend = atoi( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--time",6 ) && argc > 2 ){
+            g_benchSeconds = atof( argv[2] );
+            argv++; argc--;
+        }else
+        if( !strncmp( argv[1],"--rate",6 ) && argc > 2 ){
+            g_benchRate = atof( argv[2] );
+            argv++; argc--;
+        }else{
+            if( strncmp( argv[1],"--help",6 ) )
+                printf( "Unrecognized option: %s\n", argv[1] );
+            usage( progname );
+            exit(1);
+        }
+        argv++; argc--;
+    }
+
+    switch( mode )
+    {
+        case 's': return runSend();
+        case 'r': return runRecv();
+        case 'b': return runBench();
+    }
+    usage( progname );
+    return 1;
+}
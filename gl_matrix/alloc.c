@@ -0,0 +1,80 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "gl_matrix.h"
+#include "alloc.h"
+
+/*
+ * Storage for *_create and for functions given a NULL dest that return new
+ * storage (mat4_identity, quat_toMat4, ...).
+ *
+ * Default builds calloc, as gl-matrix.c always has.  Builds with
+ * GL_MATRIX_ARENA defined hand out slices of a per-thread arena instead,
+ * which gl_matrix_arenaReset() empties; only a full arena falls back to the
+ * heap.  Either way, heap allocations are counted and reported to the hook
+ * so callers can prove a path doesn't allocate.
+ */
+
+static __thread unsigned long gl_matrix_allocs;
+static gl_matrix_alloc_hook_t gl_matrix_hook;
+static void *gl_matrix_hookData;
+
+#ifdef GL_MATRIX_ARENA
+
+static __thread double gl_matrix_defaultArena[GL_MATRIX_ARENA_SIZE];
+static __thread double *gl_matrix_arena;
+static __thread unsigned int gl_matrix_arenaSize;
+static __thread unsigned int gl_matrix_arenaUsed;
+
+#endif
+
+static double *gl_matrix_heapAlloc(unsigned int count) {
+    gl_matrix_allocs++;
+    if (gl_matrix_hook) {
+        gl_matrix_hook(count, gl_matrix_hookData);
+    }
+    return calloc(count, sizeof(double));
+}
+
+double *gl_matrix_alloc(unsigned int count) {
+#ifdef GL_MATRIX_ARENA
+    if (!gl_matrix_arena) {
+        gl_matrix_setArena(NULL, 0);
+    }
+    if (gl_matrix_arenaSize - gl_matrix_arenaUsed >= count) {
+        double *dest = gl_matrix_arena + gl_matrix_arenaUsed;
+
+        gl_matrix_arenaUsed += count;
+        memset(dest, 0, count * sizeof(double));
+        return dest;
+    }
+#endif
+    return gl_matrix_heapAlloc(count);
+}
+
+void gl_matrix_setArena(double *buffer, unsigned int count) {
+#ifdef GL_MATRIX_ARENA
+    if (!buffer) {
+        buffer = gl_matrix_defaultArena;
+        count = GL_MATRIX_ARENA_SIZE;
+    }
+    gl_matrix_arena = buffer;
+    gl_matrix_arenaSize = count;
+    gl_matrix_arenaUsed = 0;
+#endif
+}
+
+void gl_matrix_arenaReset(void) {
+#ifdef GL_MATRIX_ARENA
+    gl_matrix_arenaUsed = 0;
+#endif
+}
+
+unsigned long gl_matrix_allocCount(void) {
+    return gl_matrix_allocs;
+}
+
+void gl_matrix_setAllocHook(gl_matrix_alloc_hook_t hook, void *userData) {
+    gl_matrix_hookData = userData;
+    gl_matrix_hook = hook;
+}
@@ -0,0 +1,10 @@
+#ifndef GL_MATRIX_ALLOC_H
+#define GL_MATRIX_ALLOC_H
+
+/*
+ * Private to gl_matrix: every vec3/quat/mat3/mat4 that gl_matrix creates
+ * itself comes from here.  Returns count zeroed doubles.
+ */
+double *gl_matrix_alloc(unsigned int count);
+
+#endif
@@ -28,6 +28,99 @@ typedef double *mat3_t;
 typedef double *mat4_t;
 typedef double *quat_t;
 
+/*
+ * Storage
+ *
+ * Functions documented as returning "a new" vector or matrix, and the
+ * *_create functions, get their storage from gl_matrix.  Normally that is
+ * calloc and the caller frees it.  When the library is built with
+ * GL_MATRIX_ARENA defined (configure --enable-glmatrix-arena) it is instead a
+ * slice of a per-thread arena of GL_MATRIX_ARENA_SIZE doubles: it must not
+ * be freed, and is only valid until the thread calls gl_matrix_arenaReset().
+ */
+
+#ifndef GL_MATRIX_ARENA_SIZE
+#define GL_MATRIX_ARENA_SIZE 1024
+#endif
+
+/*
+ * gl_matrix_setArena
+ * Gives the calling thread its own arena storage. No effect unless built
+ * with GL_MATRIX_ARENA.
+ *
+ * Params:
+ * buffer - count doubles owned by the caller, or NULL for the built-in arena
+ * count - size of buffer
+ */
+void gl_matrix_setArena(double *buffer, unsigned int count);
+
+/*
+ * gl_matrix_arenaReset
+ * Releases everything the calling thread has taken from its arena, e.g.
+ * once per frame. No effect unless built with GL_MATRIX_ARENA.
+ */
+void gl_matrix_arenaReset(void);
+
+/*
+ * gl_matrix_allocCount
+ * Counts heap allocations gl_matrix has made on the calling thread. In
+ * arena builds these only happen when the arena is full.
+ *
+ * Returns:
+ * number of allocations so far
+ */
+unsigned long gl_matrix_allocCount(void);
+
+/*
+ * gl_matrix_setAllocHook
+ * Installs a function called, on the allocating thread, for every heap
+ * allocation gl_matrix makes; NULL removes it. Intended for tests that
+ * fail when a path allocates.
+ *
+ * Params:
+ * hook - function receiving the number of doubles allocated and userData
+ * userData - passed to hook
+ */
+typedef void (*gl_matrix_alloc_hook_t)(unsigned int count, void *userData);
+void gl_matrix_setAllocHook(gl_matrix_alloc_hook_t hook, void *userData);
+
+/*
+ * SIMD
+ *
+ * mat4_multiply, mat4_inverse, mat4_transformVec3Array and the quat_*_n
+ * batch functions run on the widest kernels the CPU supports, chosen at
+ * load time unless the GL_MATRIX_SIMD environment variable names another.
+ * Every kernel set gives the same results as "scalar".
+ */
+
+/*
+ * gl_matrix_simdPath
+ * Names the kernel set in use: "scalar", "sse2", "avx" or "neon"
+ *
+ * Returns:
+ * kernel set name
+ */
+const char *gl_matrix_simdPath(void);
+
+/*
+ * gl_matrix_setSimdPath
+ * Selects the kernel set. Not thread safe; call before other threads use
+ * gl_matrix.
+ *
+ * Params:
+ * name - kernel set name, or NULL for the best available
+ *
+ * Returns:
+ * 1 if selected, 0 if name is unknown or unsupported on this CPU
+ */
+int gl_matrix_setSimdPath(const char *name);
+
+/*
+ * Batches of quaternions and vectors, one array per component (SoA)
+ */
+typedef struct { double *x, *y, *z, *w; } quat_soa_t;
+typedef struct { double *x, *y, *z; } vec3_soa_t;
+
 /*
  * vec3_t - 3 Dimensional Vector
  */
@@ -491,6 +584,22 @@ mat4_t mat4_multiplyVec3(mat4_t mat, vec3_t vec, mat4_t dest);
  */
 mat4_t mat4_multiplyVec4(mat4_t mat, vec4_t vec, mat4_t dest);
 
+/*
+ * mat4_transformVec3Array
+ * Transforms an array of vec3s with the given matrix
+ * 4th vector component is implicitly '1'
+ *
+ * Params:
+ * mat - mat4_t to transform the vectors with
+ * vecs - count vec3s packed back to back (x0, y0, z0, x1, ...)
+ * count - number of vectors
+ * dest - Optional, array receiving the results. If NULL, results are written to vecs
+ *
+ * Returns:
+ * dest if not NULL, vecs otherwise
+ */
+vec3_t mat4_transformVec3Array(mat4_t mat, vec3_t vecs, unsigned int count, vec3_t dest);
+
 /*
  * mat4_translate
  * Translates a matrix by the given vector
@@ -844,6 +953,54 @@ quat_t quat_toMat4(quat_t quat, mat4_t dest);
  */
 quat_t quat_slerp(quat_t quat, quat_t quat2, double slerp, quat_t dest);
 
+/*
+ * quat_multiply_n
+ * Performs quat_multiply on count pairs of quaternions
+ *
+ * Params:
+ * quat - first operands
+ * quat2 - second operands
+ * dest - Optional, receives the results. If NULL, results are written to quat
+ * count - number of quaternions
+ */
+void quat_multiply_n(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count);
+
+/*
+ * quat_normalize_n
+ * Performs quat_normalize on count quaternions
+ *
+ * Params:
+ * quat - quaternions to normalize
+ * dest - Optional, receives the results. If NULL, results are written to quat
+ * count - number of quaternions
+ */
+void quat_normalize_n(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count);
+
+/*
+ * quat_slerp_n
+ * Performs quat_slerp on count pairs of quaternions
+ *
+ * Params:
+ * quat - first quaternions
+ * quat2 - second quaternions
+ * slerp - count interpolation amounts
+ * dest - Optional, receives the results. If NULL, results are written to quat
+ * count - number of quaternions
+ */
+void quat_slerp_n(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count);
+
+/*
+ * quat_rotate_vec3_n
+ * Performs quat_multiplyVec3 on count quaternion/vector pairs
+ *
+ * Params:
+ * quat - rotations
+ * vec - vectors to rotate
+ * dest - Optional, receives the results. If NULL, results are written to vec
+ * count - number of vectors
+ */
+void quat_rotate_vec3_n(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count);
+
 /*
  * quat_str
  * Writes a string representation of a quaternion
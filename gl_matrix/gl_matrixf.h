@@ -0,0 +1,369 @@
+#ifndef GL_MATRIXF_H
+#define GL_MATRIXF_H
+
+/*
+ * gl_matrixf.h - Header-only single precision variant of gl-matrix.c
+ *
+ * Vectors, quaternions and matrices are small structs passed and returned
+ * by value, so the compiler can keep them in registers and never has to
+ * assume two arguments alias.  Nothing here allocates.  Matrices use the
+ * same column-major layout as gl_matrix.h (and OpenGL), so mat4f.m can be
+ * handed straight to glUniformMatrix4fv.
+ *
+ * Operations mirror their gl_matrix.h counterparts; the only pointers left
+ * are the load/store helpers that convert to and from the double API.
+ */
+
+#include <math.h>
+
+#ifdef __cplusplus
+#define GLMF_RESTRICT __restrict
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define GLMF_RESTRICT restrict
+#else
+#define GLMF_RESTRICT __restrict
+#endif
+
+#if defined(__GNUC__)
+#define GLMF_ALIGN16 __attribute__((aligned(16)))
+#else
+#define GLMF_ALIGN16
+#endif
+
+typedef struct { float x, y, z; } vec3f;
+typedef struct { float x, y, z, w; } GLMF_ALIGN16 quatf;
+typedef struct { float m[16]; } GLMF_ALIGN16 mat4f;
+
+/*
+ * vec3f - 3 Dimensional Vector
+ */
+
+static inline vec3f vec3f_make(float x, float y, float z) {
+    vec3f r;
+    r.x = x; r.y = y; r.z = z;
+    return r;
+}
+
+static inline vec3f vec3f_add(vec3f a, vec3f b) {
+    return vec3f_make(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+static inline vec3f vec3f_subtract(vec3f a, vec3f b) {
+    return vec3f_make(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline vec3f vec3f_multiply(vec3f a, vec3f b) {
+    return vec3f_make(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+static inline vec3f vec3f_negate(vec3f a) {
+    return vec3f_make(-a.x, -a.y, -a.z);
+}
+
+static inline vec3f vec3f_scale(vec3f a, float s) {
+    return vec3f_make(a.x * s, a.y * s, a.z * s);
+}
+
+static inline float vec3f_dot(vec3f a, vec3f b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline vec3f vec3f_cross(vec3f a, vec3f b) {
+    return vec3f_make(a.y * b.z - a.z * b.y,
+                      a.z * b.x - a.x * b.z,
+                      a.x * b.y - a.y * b.x);
+}
+
+static inline float vec3f_length(vec3f a) {
+    return sqrtf(vec3f_dot(a, a));
+}
+
+/* Returns [0, 0, 0] for a zero-length vector, as vec3_normalize does */
+static inline vec3f vec3f_normalize(vec3f a) {
+    float len = vec3f_length(a);
+    if (len == 0) {
+        return vec3f_make(0, 0, 0);
+    }
+    return vec3f_scale(a, 1 / len);
+}
+
+static inline vec3f vec3f_lerp(vec3f a, vec3f b, float t) {
+    return vec3f_make(a.x + t * (b.x - a.x),
+                      a.y + t * (b.y - a.y),
+                      a.z + t * (b.z - a.z));
+}
+
+static inline float vec3f_dist(vec3f a, vec3f b) {
+    return vec3f_length(vec3f_subtract(b, a));
+}
+
+static inline vec3f vec3f_load(const double * GLMF_RESTRICT v) {
+    return vec3f_make((float)v[0], (float)v[1], (float)v[2]);
+}
+
+static inline void vec3f_store(vec3f a, double * GLMF_RESTRICT dest) {
+    dest[0] = a.x; dest[1] = a.y; dest[2] = a.z;
+}
+
+/*
+ * quatf - Quaternion, [x, y, z, w] as in quat_t
+ */
+
+static inline quatf quatf_make(float x, float y, float z, float w) {
+    quatf r;
+    r.x = x; r.y = y; r.z = z; r.w = w;
+    return r;
+}
+
+static inline quatf quatf_identity(void) {
+    return quatf_make(0, 0, 0, 1);
+}
+
+static inline float quatf_dot(quatf a, quatf b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+static inline float quatf_length(quatf a) {
+    return sqrtf(quatf_dot(a, a));
+}
+
+static inline quatf quatf_conjugate(quatf a) {
+    return quatf_make(-a.x, -a.y, -a.z, a.w);
+}
+
+static inline quatf quatf_inverse(quatf a) {
+    float invDot = 1 / quatf_dot(a, a);
+    return quatf_make(-a.x * invDot, -a.y * invDot, -a.z * invDot, a.w * invDot);
+}
+
+/* Returns [0, 0, 0, 0] for a zero-length quaternion, as quat_normalize does */
+static inline quatf quatf_normalize(quatf a) {
+    float len = quatf_length(a);
+    if (len == 0) {
+        return quatf_make(0, 0, 0, 0);
+    }
+    len = 1 / len;
+    return quatf_make(a.x * len, a.y * len, a.z * len, a.w * len);
+}
+
+static inline quatf quatf_multiply(quatf a, quatf b) {
+    return quatf_make(a.x * b.w + a.w * b.x + a.y * b.z - a.z * b.y,
+                      a.y * b.w + a.w * b.y + a.z * b.x - a.x * b.z,
+                      a.z * b.w + a.w * b.z + a.x * b.y - a.y * b.x,
+                      a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+}
+
+/* Rotates v by q (q * v * q^-1 for unit q) */
+static inline vec3f quatf_multiplyVec3(quatf q, vec3f v) {
+    float ix =  q.w * v.x + q.y * v.z - q.z * v.y,
+          iy =  q.w * v.y + q.z * v.x - q.x * v.z,
+          iz =  q.w * v.z + q.x * v.y - q.y * v.x,
+          iw = -q.x * v.x - q.y * v.y - q.z * v.z;
+
+    return vec3f_make(ix * q.w + iw * -q.x + iy * -q.z - iz * -q.y,
+                      iy * q.w + iw * -q.y + iz * -q.x - ix * -q.z,
+                      iz * q.w + iw * -q.z + ix * -q.y - iy * -q.x);
+}
+
+static inline quatf quatf_slerp(quatf a, quatf b, float t) {
+    float cosHalfTheta = quatf_dot(a, b);
+
+    if (fabsf(cosHalfTheta) >= 1.0f) {
+        return a;
+    }
+
+    float halfTheta = acosf(cosHalfTheta);
+    float sinHalfTheta = sqrtf(1.0f - cosHalfTheta * cosHalfTheta);
+    float ratioA, ratioB;
+
+    if (fabsf(sinHalfTheta) < 0.001f) {
+        ratioA = 1 - t;
+        ratioB = t;
+    } else {
+        ratioA = sinf((1 - t) * halfTheta) / sinHalfTheta;
+        ratioB = sinf(t * halfTheta) / sinHalfTheta;
+    }
+
+    return quatf_make(a.x * ratioA + b.x * ratioB,
+                      a.y * ratioA + b.y * ratioB,
+                      a.z * ratioA + b.z * ratioB,
+                      a.w * ratioA + b.w * ratioB);
+}
+
+static inline quatf quatf_load(const double * GLMF_RESTRICT q) {
+    return quatf_make((float)q[0], (float)q[1], (float)q[2], (float)q[3]);
+}
+
+static inline void quatf_store(quatf a, double * GLMF_RESTRICT dest) {
+    dest[0] = a.x; dest[1] = a.y; dest[2] = a.z; dest[3] = a.w;
+}
+
+/*
+ * mat4f - 4x4 Matrix, column-major
+ */
+
+static inline mat4f mat4f_identity(void) {
+    mat4f r;
+    int i;
+    for (i = 0; i < 16; i++) {
+        r.m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+    return r;
+}
+
+static inline mat4f mat4f_transpose(mat4f a) {
+    mat4f r;
+    int c, k;
+    for (c = 0; c < 4; c++) {
+        for (k = 0; k < 4; k++) {
+            r.m[c * 4 + k] = a.m[k * 4 + c];
+        }
+    }
+    return r;
+}
+
+/* a * b, matching mat4_multiply(a, b, dest) */
+static inline mat4f mat4f_multiply(mat4f a, mat4f b) {
+    mat4f r;
+    int c, k;
+    for (c = 0; c < 4; c++) {
+        float b0 = b.m[c * 4 + 0], b1 = b.m[c * 4 + 1],
+              b2 = b.m[c * 4 + 2], b3 = b.m[c * 4 + 3];
+        for (k = 0; k < 4; k++) {
+            r.m[c * 4 + k] = b0 * a.m[k] + b1 * a.m[4 + k] + b2 * a.m[8 + k] + b3 * a.m[12 + k];
+        }
+    }
+    return r;
+}
+
+/*
+ * mat4f_inverse
+ * Returns the inverse of a.  If a is singular, *ok (when not NULL) is set to 0
+ * and a is returned unchanged; mat4_inverse returns NULL in that case.
+ */
+static inline mat4f mat4f_inverse(mat4f a, int *ok) {
+    const float *s = a.m;
+    float b00 = s[0] * s[5] - s[1] * s[4],
+          b01 = s[0] * s[6] - s[2] * s[4],
+          b02 = s[0] * s[7] - s[3] * s[4],
+          b03 = s[1] * s[6] - s[2] * s[5],
+          b04 = s[1] * s[7] - s[3] * s[5],
+          b05 = s[2] * s[7] - s[3] * s[6],
+          b06 = s[8] * s[13] - s[9] * s[12],
+          b07 = s[8] * s[14] - s[10] * s[12],
+          b08 = s[8] * s[15] - s[11] * s[12],
+          b09 = s[9] * s[14] - s[10] * s[13],
+          b10 = s[9] * s[15] - s[11] * s[13],
+          b11 = s[10] * s[15] - s[11] * s[14],
+          d = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+    mat4f r;
+
+    if (ok) { *ok = (d != 0); }
+    if (d == 0) {
+        return a;
+    }
+    d = 1 / d;
+
+    r.m[0]  = ( s[5] * b11 - s[6] * b10 + s[7] * b09) * d;
+    r.m[1]  = (-s[1] * b11 + s[2] * b10 - s[3] * b09) * d;
+    r.m[2]  = ( s[13] * b05 - s[14] * b04 + s[15] * b03) * d;
+    r.m[3]  = (-s[9] * b05 + s[10] * b04 - s[11] * b03) * d;
+    r.m[4]  = (-s[4] * b11 + s[6] * b08 - s[7] * b07) * d;
+    r.m[5]  = ( s[0] * b11 - s[2] * b08 + s[3] * b07) * d;
+    r.m[6]  = (-s[12] * b05 + s[14] * b02 - s[15] * b01) * d;
+    r.m[7]  = ( s[8] * b05 - s[10] * b02 + s[11] * b01) * d;
+    r.m[8]  = ( s[4] * b10 - s[5] * b08 + s[7] * b06) * d;
+    r.m[9]  = (-s[0] * b10 + s[1] * b08 - s[3] * b06) * d;
+    r.m[10] = ( s[12] * b04 - s[13] * b02 + s[15] * b00) * d;
+    r.m[11] = (-s[8] * b04 + s[9] * b02 - s[11] * b00) * d;
+    r.m[12] = (-s[4] * b09 + s[5] * b07 - s[6] * b06) * d;
+    r.m[13] = ( s[0] * b09 - s[1] * b07 + s[2] * b06) * d;
+    r.m[14] = (-s[12] * b03 + s[13] * b01 - s[14] * b00) * d;
+    r.m[15] = ( s[8] * b03 - s[9] * b01 + s[10] * b00) * d;
+    return r;
+}
+
+/* Transforms point v (w = 1) by a */
+static inline vec3f mat4f_multiplyVec3(mat4f a, vec3f v) {
+    return vec3f_make(a.m[0] * v.x + a.m[4] * v.y + a.m[8]  * v.z + a.m[12],
+                      a.m[1] * v.x + a.m[5] * v.y + a.m[9]  * v.z + a.m[13],
+                      a.m[2] * v.x + a.m[6] * v.y + a.m[10] * v.z + a.m[14]);
+}
+
+static inline mat4f mat4f_translate(mat4f a, vec3f v) {
+    int k;
+    for (k = 0; k < 4; k++) {
+        a.m[12 + k] = a.m[k] * v.x + a.m[4 + k] * v.y + a.m[8 + k] * v.z + a.m[12 + k];
+    }
+    return a;
+}
+
+static inline mat4f mat4f_scale(mat4f a, vec3f v) {
+    int k;
+    for (k = 0; k < 4; k++) {
+        a.m[k]     *= v.x;
+        a.m[4 + k] *= v.y;
+        a.m[8 + k] *= v.z;
+    }
+    return a;
+}
+
+static inline mat4f mat4f_frustum(float left, float right, float bottom, float top, float near, float far) {
+    float rl = right - left, tb = top - bottom, fn = far - near;
+    mat4f r;
+    int i;
+    for (i = 0; i < 16; i++) {
+        r.m[i] = 0;
+    }
+    r.m[0]  = (near * 2) / rl;
+    r.m[5]  = (near * 2) / tb;
+    r.m[8]  = (right + left) / rl;
+    r.m[9]  = (top + bottom) / tb;
+    r.m[10] = -(far + near) / fn;
+    r.m[11] = -1;
+    r.m[14] = -(far * near * 2) / fn;
+    return r;
+}
+
+/* fovy in degrees, as mat4_perspective */
+static inline mat4f mat4f_perspective(float fovy, float aspect, float near, float far) {
+    float top = near * tanf(fovy * 3.14159265358979f / 360.0f),
+          right = top * aspect;
+    return mat4f_frustum(-right, right, -top, top, near, far);
+}
+
+static inline mat4f mat4f_fromRotationTranslation(quatf q, vec3f v) {
+    float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z,
+          xx = q.x * x2, xy = q.x * y2, xz = q.x * z2,
+          yy = q.y * y2, yz = q.y * z2, zz = q.z * z2,
+          wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+    mat4f r;
+
+    r.m[0]  = 1 - (yy + zz); r.m[1]  = xy + wz;       r.m[2]  = xz - wy;       r.m[3]  = 0;
+    r.m[4]  = xy - wz;       r.m[5]  = 1 - (xx + zz); r.m[6]  = yz + wx;       r.m[7]  = 0;
+    r.m[8]  = xz + wy;       r.m[9]  = yz - wx;       r.m[10] = 1 - (xx + yy); r.m[11] = 0;
+    r.m[12] = v.x;           r.m[13] = v.y;           r.m[14] = v.z;           r.m[15] = 1;
+    return r;
+}
+
+static inline mat4f quatf_toMat4(quatf q) {
+    return mat4f_fromRotationTranslation(q, vec3f_make(0, 0, 0));
+}
+
+static inline mat4f mat4f_load(const double * GLMF_RESTRICT mat) {
+    mat4f r;
+    int i;
+    for (i = 0; i < 16; i++) {
+        r.m[i] = (float)mat[i];
+    }
+    return r;
+}
+
+static inline void mat4f_store(mat4f a, double * GLMF_RESTRICT dest) {
+    int i;
+    for (i = 0; i < 16; i++) {
+        dest[i] = a.m[i];
+    }
+}
+
+#endif
@@ -2,9 +2,10 @@
 #include <math.h>
 
 #include "gl_matrix.h"
+#include "alloc.h"
 
 mat3_t mat3_create(mat3_t mat) {
-    mat3_t dest = calloc(sizeof(double), 9);
+    mat3_t dest = gl_matrix_alloc(9);
 
     if (mat) {
         dest[0] = mat[0];
@@ -3,9 +3,11 @@
 #include <math.h>
 
 #include "gl_matrix.h"
+#include "alloc.h"
+#include "simd.h"
 
 mat4_t mat4_create(mat4_t mat) {
-    mat4_t dest = calloc(sizeof(double), 16);
+    mat4_t dest = gl_matrix_alloc(16);
 
     if (mat) {
         dest[0] = mat[0];
@@ -126,9 +128,7 @@ double mat4_determinant(mat4_t mat) {
             a20 * a01 * a12 * a33 - a00 * a21 * a12 * a33 - a10 * a01 * a22 * a33 + a00 * a11 * a22 * a33);
 }
 
-mat4_t mat4_inverse(mat4_t mat, mat4_t dest) {
-    if (!dest) { dest = mat; }
-
+int mat4_inverse_scalar(const double *mat, double *dest) {
     // Cache the matrix values (makes for huge speed increases!)
     double a00 = mat[0], a01 = mat[1], a02 = mat[2], a03 = mat[3],
         a10 = mat[4], a11 = mat[5], a12 = mat[6], a13 = mat[7],
@@ -152,7 +152,7 @@ mat4_t mat4_inverse(mat4_t mat, mat4_t dest) {
         invDet;
 
         // Calculate the determinant
-        if (!d) { return NULL; }
+        if (!d) { return 0; }
         invDet = 1 / d;
 
     dest[0] = (a11 * b11 - a12 * b10 + a13 * b09) * invDet;
@@ -172,7 +172,13 @@ mat4_t mat4_inverse(mat4_t mat, mat4_t dest) {
     dest[14] = (-a30 * b03 + a31 * b01 - a32 * b00) * invDet;
     dest[15] = (a20 * b03 - a21 * b01 + a22 * b00) * invDet;
 
-    return dest;
+    return 1;
+}
+
+mat4_t mat4_inverse(mat4_t mat, mat4_t dest) {
+    if (!dest) { dest = mat; }
+
+    return gl_matrix_kernels->inverse(mat, dest) ? dest : NULL;
 }
 
 mat4_t mat4_toRotationMat(mat4_t mat, mat4_t dest) {
@@ -245,9 +251,7 @@ mat3_t mat4_toInverseMat3(mat4_t mat, mat3_t dest) {
     return dest;
 }
 
-mat4_t mat4_multiply(mat4_t mat, mat4_t mat2, mat4_t dest) {
-    if (!dest) { dest = mat; }
-
+void mat4_multiply_scalar(const double *mat, const double *mat2, double *dest) {
     // Cache the matrix values (makes for huge speed increases!)
     double a00 = mat[0], a01 = mat[1], a02 = mat[2], a03 = mat[3],
         a10 = mat[4], a11 = mat[5], a12 = mat[6], a13 = mat[7],
@@ -275,7 +279,12 @@ mat4_t mat4_multiply(mat4_t mat, mat4_t mat2, mat4_t dest) {
     dest[13] = b30 * a01 + b31 * a11 + b32 * a21 + b33 * a31;
     dest[14] = b30 * a02 + b31 * a12 + b32 * a22 + b33 * a32;
     dest[15] = b30 * a03 + b31 * a13 + b32 * a23 + b33 * a33;
+}
 
+mat4_t mat4_multiply(mat4_t mat, mat4_t mat2, mat4_t dest) {
+    if (!dest) { dest = mat; }
+
+    gl_matrix_kernels->multiply(mat, mat2, dest);
     return dest;
 }
 
@@ -291,6 +300,25 @@ mat4_t mat4_multiplyVec3(mat4_t mat, vec3_t vec, mat4_t dest) {
     return dest;
 }
 
+void mat4_transformVec3Array_scalar(const double *mat, const double *vecs, unsigned int count, double *dest) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++, vecs += 3, dest += 3) {
+        double x = vecs[0], y = vecs[1], z = vecs[2];
+
+        dest[0] = mat[0] * x + mat[4] * y + mat[8] * z + mat[12];
+        dest[1] = mat[1] * x + mat[5] * y + mat[9] * z + mat[13];
+        dest[2] = mat[2] * x + mat[6] * y + mat[10] * z + mat[14];
+    }
+}
+
+vec3_t mat4_transformVec3Array(mat4_t mat, vec3_t vecs, unsigned int count, vec3_t dest) {
+    if (!dest) { dest = vecs; }
+
+    gl_matrix_kernels->transformVec3Array(mat, vecs, count, dest);
+    return dest;
+}
+
 mat4_t mat4_multiplyVec4(mat4_t mat, vec4_t vec, mat4_t dest) {
     if (!dest) { dest = vec; }
 
@@ -0,0 +1,174 @@
+#include "gl_matrix.h"
+#include "simd.h"
+
+/*
+ * SIMD kernels for mat4_multiply, mat4_inverse and mat4_transformVec3Array.
+ *
+ * Every kernel evaluates each element with the same products, in the same
+ * order, as the scalar code in mat4.c (subtractions are folded into negated
+ * operands, which IEEE defines as the same operation), so all paths agree
+ * bit-for-bit unless the compiler is allowed to contract mul+add into FMA.
+ */
+
+/*
+ * 2-wide double vectors: SSE2 on x86, NEON on AArch64
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define V2_TARGET __attribute__((target("sse2")))
+
+typedef __m128d v2d;
+
+static inline V2_TARGET v2d v2_load(const double *p) { return _mm_loadu_pd(p); }
+static inline V2_TARGET void v2_store(double *p, v2d v) { _mm_storeu_pd(p, v); }
+static inline V2_TARGET void v2_storeLow(double *p, v2d v) { _mm_store_sd(p, v); }
+static inline V2_TARGET v2d v2_set(double x, double y) { return _mm_setr_pd(x, y); }
+static inline V2_TARGET v2d v2_splat(double x) { return _mm_set1_pd(x); }
+static inline V2_TARGET v2d v2_add(v2d a, v2d b) { return _mm_add_pd(a, b); }
+static inline V2_TARGET v2d v2_sub(v2d a, v2d b) { return _mm_sub_pd(a, b); }
+static inline V2_TARGET v2d v2_mul(v2d a, v2d b) { return _mm_mul_pd(a, b); }
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+#define V2_TARGET
+
+typedef float64x2_t v2d;
+
+static inline v2d v2_load(const double *p) { return vld1q_f64(p); }
+static inline void v2_store(double *p, v2d v) { vst1q_f64(p, v); }
+static inline void v2_storeLow(double *p, v2d v) { vst1q_lane_f64(p, v, 0); }
+static inline v2d v2_set(double x, double y) { return vsetq_lane_f64(y, vdupq_n_f64(x), 1); }
+static inline v2d v2_splat(double x) { return vdupq_n_f64(x); }
+static inline v2d v2_add(v2d a, v2d b) { return vaddq_f64(a, b); }
+static inline v2d v2_sub(v2d a, v2d b) { return vsubq_f64(a, b); }
+static inline v2d v2_mul(v2d a, v2d b) { return vmulq_f64(a, b); }
+
+#endif
+
+#ifdef GL_MATRIX_HAVE_V2
+
+/* ((p1 * q1 + p2 * q2) + p3 * q3) * s */
+static inline V2_TARGET v2d v2_dot3(v2d p1, double q1, v2d p2, double q2, v2d p3, double q3, v2d s) {
+    return v2_mul(v2_add(v2_add(v2_mul(p1, v2_splat(q1)), v2_mul(p2, v2_splat(q2))),
+                         v2_mul(p3, v2_splat(q3))), s);
+}
+
+V2_TARGET void mat4_multiply_v2(const double *mat, const double *mat2, double *dest) {
+    v2d a0l = v2_load(mat), a0h = v2_load(mat + 2),
+        a1l = v2_load(mat + 4), a1h = v2_load(mat + 6),
+        a2l = v2_load(mat + 8), a2h = v2_load(mat + 10),
+        a3l = v2_load(mat + 12), a3h = v2_load(mat + 14),
+        r[8];
+    int i;
+
+    // All results are formed before any store, since dest may be mat or mat2
+    for (i = 0; i < 4; i++) {
+        v2d b0 = v2_splat(mat2[i * 4]), b1 = v2_splat(mat2[i * 4 + 1]),
+            b2 = v2_splat(mat2[i * 4 + 2]), b3 = v2_splat(mat2[i * 4 + 3]);
+
+        r[i * 2] = v2_add(v2_add(v2_add(v2_mul(b0, a0l), v2_mul(b1, a1l)), v2_mul(b2, a2l)), v2_mul(b3, a3l));
+        r[i * 2 + 1] = v2_add(v2_add(v2_add(v2_mul(b0, a0h), v2_mul(b1, a1h)), v2_mul(b2, a2h)), v2_mul(b3, a3h));
+    }
+
+    for (i = 0; i < 8; i++) {
+        v2_store(dest + i * 2, r[i]);
+    }
+}
+
+V2_TARGET int mat4_inverse_v2(const double *mat, double *dest) {
+    double a00 = mat[0], a01 = mat[1], a02 = mat[2], a03 = mat[3],
+        a10 = mat[4], a11 = mat[5], a12 = mat[6], a13 = mat[7],
+        a20 = mat[8], a21 = mat[9], a22 = mat[10], a23 = mat[11],
+        a30 = mat[12], a31 = mat[13], a32 = mat[14], a33 = mat[15],
+        b[12], d;
+    v2d invDet;
+
+    v2_store(b + 0, v2_sub(v2_mul(v2_splat(a00), v2_load(mat + 5)), v2_mul(v2_load(mat + 1), v2_splat(a10))));
+    v2_store(b + 2, v2_sub(v2_mul(v2_set(a00, a01), v2_set(a13, a12)), v2_mul(v2_set(a03, a02), v2_set(a10, a11))));
+    v2_store(b + 4, v2_sub(v2_mul(v2_load(mat + 1), v2_splat(a13)), v2_mul(v2_splat(a03), v2_load(mat + 5))));
+    v2_store(b + 6, v2_sub(v2_mul(v2_splat(a20), v2_load(mat + 13)), v2_mul(v2_load(mat + 9), v2_splat(a30))));
+    v2_store(b + 8, v2_sub(v2_mul(v2_set(a20, a21), v2_set(a33, a32)), v2_mul(v2_set(a23, a22), v2_set(a30, a31))));
+    v2_store(b + 10, v2_sub(v2_mul(v2_load(mat + 9), v2_splat(a33)), v2_mul(v2_splat(a23), v2_load(mat + 13))));
+
+    d = (b[0] * b[11] - b[1] * b[10] + b[2] * b[9] + b[3] * b[8] - b[4] * b[7] + b[5] * b[6]);
+    if (!d) { return 0; }
+    invDet = v2_splat(1 / d);
+
+    // Each pair of outputs shares its cofactors; signs ride on the matrix terms
+    v2_store(dest + 0, v2_dot3(v2_set(a11, -a01), b[11], v2_set(-a12, a02), b[10], v2_set(a13, -a03), b[9], invDet));
+    v2_store(dest + 2, v2_dot3(v2_set(a31, -a21), b[5], v2_set(-a32, a22), b[4], v2_set(a33, -a23), b[3], invDet));
+    v2_store(dest + 4, v2_dot3(v2_set(-a10, a00), b[11], v2_set(a12, -a02), b[8], v2_set(-a13, a03), b[7], invDet));
+    v2_store(dest + 6, v2_dot3(v2_set(-a30, a20), b[5], v2_set(a32, -a22), b[2], v2_set(-a33, a23), b[1], invDet));
+    v2_store(dest + 8, v2_dot3(v2_set(a10, -a00), b[10], v2_set(-a11, a01), b[8], v2_set(a13, -a03), b[6], invDet));
+    v2_store(dest + 10, v2_dot3(v2_set(a30, -a20), b[4], v2_set(-a31, a21), b[2], v2_set(a33, -a23), b[0], invDet));
+    v2_store(dest + 12, v2_dot3(v2_set(-a10, a00), b[9], v2_set(a11, -a01), b[7], v2_set(-a12, a02), b[6], invDet));
+    v2_store(dest + 14, v2_dot3(v2_set(-a30, a20), b[3], v2_set(a31, -a21), b[1], v2_set(-a32, a22), b[0], invDet));
+
+    return 1;
+}
+
+V2_TARGET void mat4_transformVec3Array_v2(const double *mat, const double *vecs, unsigned int count, double *dest) {
+    v2d c0l = v2_load(mat), c0h = v2_load(mat + 2),
+        c1l = v2_load(mat + 4), c1h = v2_load(mat + 6),
+        c2l = v2_load(mat + 8), c2h = v2_load(mat + 10),
+        c3l = v2_load(mat + 12), c3h = v2_load(mat + 14);
+    unsigned int i;
+
+    for (i = 0; i < count; i++, vecs += 3, dest += 3) {
+        v2d x = v2_splat(vecs[0]), y = v2_splat(vecs[1]), z = v2_splat(vecs[2]);
+
+        v2_store(dest, v2_add(v2_add(v2_add(v2_mul(c0l, x), v2_mul(c1l, y)), v2_mul(c2l, z)), c3l));
+        v2_storeLow(dest + 2, v2_add(v2_add(v2_add(v2_mul(c0h, x), v2_mul(c1h, y)), v2_mul(c2h, z)), c3h));
+    }
+}
+
+#endif
+
+/*
+ * 4-wide double vectors: AVX on x86
+ */
+
+#ifdef GL_MATRIX_HAVE_AVX
+
+AVX_TARGET void mat4_multiply_avx(const double *mat, const double *mat2, double *dest) {
+    __m256d a0 = _mm256_loadu_pd(mat), a1 = _mm256_loadu_pd(mat + 4),
+        a2 = _mm256_loadu_pd(mat + 8), a3 = _mm256_loadu_pd(mat + 12),
+        r[4];
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        r[i] = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+                   _mm256_mul_pd(_mm256_broadcast_sd(mat2 + i * 4), a0),
+                   _mm256_mul_pd(_mm256_broadcast_sd(mat2 + i * 4 + 1), a1)),
+                   _mm256_mul_pd(_mm256_broadcast_sd(mat2 + i * 4 + 2), a2)),
+                   _mm256_mul_pd(_mm256_broadcast_sd(mat2 + i * 4 + 3), a3));
+    }
+
+    for (i = 0; i < 4; i++) {
+        _mm256_storeu_pd(dest + i * 4, r[i]);
+    }
+}
+
+AVX_TARGET void mat4_transformVec3Array_avx(const double *mat, const double *vecs, unsigned int count, double *dest) {
+    __m256d c0 = _mm256_loadu_pd(mat), c1 = _mm256_loadu_pd(mat + 4),
+        c2 = _mm256_loadu_pd(mat + 8), c3 = _mm256_loadu_pd(mat + 12);
+    unsigned int i;
+
+    for (i = 0; i < count; i++, vecs += 3, dest += 3) {
+        __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+                        _mm256_mul_pd(c0, _mm256_broadcast_sd(vecs)),
+                        _mm256_mul_pd(c1, _mm256_broadcast_sd(vecs + 1))),
+                        _mm256_mul_pd(c2, _mm256_broadcast_sd(vecs + 2))), c3);
+
+        // Only xyz: a 4-wide store would clobber the next vector
+        _mm_storeu_pd(dest, _mm256_castpd256_pd128(r));
+        _mm_store_sd(dest + 2, _mm256_extractf128_pd(r, 1));
+    }
+}
+
+#endif
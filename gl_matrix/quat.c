@@ -2,9 +2,11 @@
 #include <math.h>
 
 #include "gl_matrix.h"
+#include "alloc.h"
+#include "simd.h"
 
 quat_t quat_create(quat_t quat) {
-    quat_t dest = calloc(sizeof(double), 4);
+    quat_t dest = gl_matrix_alloc(4);
 
     if (quat) {
         dest[0] = quat[0];
@@ -217,7 +219,7 @@ quat_t quat_slerp(quat_t quat, quat_t quat2, double slerp, quat_t dest) {
         ratioA,
         ratioB;
 
-    if (abs(cosHalfTheta) >= 1.0) {
+    if (fabs(cosHalfTheta) >= 1.0) {
         if (dest != quat) {
             dest[0] = quat[0];
             dest[1] = quat[1];
@@ -230,11 +232,12 @@ quat_t quat_slerp(quat_t quat, quat_t quat2, double slerp, quat_t dest) {
     halfTheta = acos(cosHalfTheta);
     sinHalfTheta = sqrt(1.0 - cosHalfTheta * cosHalfTheta);
 
-    if (abs(sinHalfTheta) < 0.001) {
-        dest[0] = (quat[0] * 0.5 + quat2[0] * 0.5);
-        dest[1] = (quat[1] * 0.5 + quat2[1] * 0.5);
-        dest[2] = (quat[2] * 0.5 + quat2[2] * 0.5);
-        dest[3] = (quat[3] * 0.5 + quat2[3] * 0.5);
+    // Nearly identical rotations; fall back to a linear blend
+    if (fabs(sinHalfTheta) < 0.001) {
+        dest[0] = (quat[0] * (1 - slerp) + quat2[0] * slerp);
+        dest[1] = (quat[1] * (1 - slerp) + quat2[1] * slerp);
+        dest[2] = (quat[2] * (1 - slerp) + quat2[2] * slerp);
+        dest[3] = (quat[3] * (1 - slerp) + quat2[3] * slerp);
         return dest;
     }
 
@@ -248,3 +251,96 @@ quat_t quat_slerp(quat_t quat, quat_t quat2, double slerp, quat_t dest) {
 
     return dest;
 }
+
+/*
+ * Batch operations.  The scalar kernels spell out the same expressions as
+ * the single-quaternion functions above, and every other kernel set is
+ * checked against them.
+ */
+
+void quat_multiply_n_scalar(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        double qax = quat->x[i], qay = quat->y[i], qaz = quat->z[i], qaw = quat->w[i],
+            qbx = quat2->x[i], qby = quat2->y[i], qbz = quat2->z[i], qbw = quat2->w[i];
+
+        dest->x[i] = qax * qbw + qaw * qbx + qay * qbz - qaz * qby;
+        dest->y[i] = qay * qbw + qaw * qby + qaz * qbx - qax * qbz;
+        dest->z[i] = qaz * qbw + qaw * qbz + qax * qby - qay * qbx;
+        dest->w[i] = qaw * qbw - qax * qbx - qay * qby - qaz * qbz;
+    }
+}
+
+void quat_normalize_n_scalar(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        double x = quat->x[i], y = quat->y[i], z = quat->z[i], w = quat->w[i],
+            len = sqrt(x * x + y * y + z * z + w * w);
+
+        if (len == 0) {
+            dest->x[i] = dest->y[i] = dest->z[i] = dest->w[i] = 0;
+            continue;
+        }
+        len = 1 / len;
+        dest->x[i] = x * len;
+        dest->y[i] = y * len;
+        dest->z[i] = z * len;
+        dest->w[i] = w * len;
+    }
+}
+
+void quat_slerp_n_scalar(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        double a[4] = { quat->x[i], quat->y[i], quat->z[i], quat->w[i] },
+            b[4] = { quat2->x[i], quat2->y[i], quat2->z[i], quat2->w[i] };
+
+        quat_slerp(a, b, slerp[i], NULL);
+        dest->x[i] = a[0]; dest->y[i] = a[1]; dest->z[i] = a[2]; dest->w[i] = a[3];
+    }
+}
+
+void quat_rotate_vec3_n_scalar(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        double x = vec->x[i], y = vec->y[i], z = vec->z[i],
+            qx = quat->x[i], qy = quat->y[i], qz = quat->z[i], qw = quat->w[i],
+
+            ix = qw * x + qy * z - qz * y,
+            iy = qw * y + qz * x - qx * z,
+            iz = qw * z + qx * y - qy * x,
+            iw = -qx * x - qy * y - qz * z;
+
+        dest->x[i] = ix * qw + iw * -qx + iy * -qz - iz * -qy;
+        dest->y[i] = iy * qw + iw * -qy + iz * -qx - ix * -qz;
+        dest->z[i] = iz * qw + iw * -qz + ix * -qy - iy * -qx;
+    }
+}
+
+void quat_multiply_n(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count) {
+    if (!dest) { dest = quat; }
+
+    gl_matrix_kernels->quatMultiply(quat, quat2, dest, count);
+}
+
+void quat_normalize_n(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count) {
+    if (!dest) { dest = quat; }
+
+    gl_matrix_kernels->quatNormalize(quat, dest, count);
+}
+
+void quat_slerp_n(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count) {
+    if (!dest) { dest = quat; }
+
+    gl_matrix_kernels->quatSlerp(quat, quat2, slerp, dest, count);
+}
+
+void quat_rotate_vec3_n(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count) {
+    if (!dest) { dest = vec; }
+
+    gl_matrix_kernels->quatRotateVec3(quat, vec, dest, count);
+}
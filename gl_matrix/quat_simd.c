@@ -0,0 +1,169 @@
+#include <math.h>
+
+#include "gl_matrix.h"
+#include "simd.h"
+
+/*
+ * AVX kernels for the quat_*_n batch functions, four quaternions at a time
+ * from SoA arrays.  As with the mat4 kernels each result is formed from the
+ * same operations, in the same order, as the single-quaternion code, so the
+ * results match it bit-for-bit.  Counts that aren't a multiple of four
+ * finish on the scalar kernels.
+ *
+ * Only AVX is needed: AVX2 adds integer instructions, and FMA would change
+ * the rounding.
+ */
+
+#ifdef GL_MATRIX_HAVE_AVX
+
+#include <immintrin.h>
+
+static inline quat_soa_t quat_soa_at(const quat_soa_t *q, unsigned int i) {
+    quat_soa_t r = { q->x + i, q->y + i, q->z + i, q->w + i };
+    return r;
+}
+
+static inline vec3_soa_t vec3_soa_at(const vec3_soa_t *v, unsigned int i) {
+    vec3_soa_t r = { v->x + i, v->y + i, v->z + i };
+    return r;
+}
+
+static inline AVX_TARGET __m256d avx_neg(__m256d a) {
+    return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+}
+
+AVX_TARGET void quat_multiply_n_avx(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m256d ax = _mm256_loadu_pd(quat->x + i), ay = _mm256_loadu_pd(quat->y + i),
+            az = _mm256_loadu_pd(quat->z + i), aw = _mm256_loadu_pd(quat->w + i),
+            bx = _mm256_loadu_pd(quat2->x + i), by = _mm256_loadu_pd(quat2->y + i),
+            bz = _mm256_loadu_pd(quat2->z + i), bw = _mm256_loadu_pd(quat2->w + i);
+
+        _mm256_storeu_pd(dest->x + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(ax, bw), _mm256_mul_pd(aw, bx)), _mm256_mul_pd(ay, bz)), _mm256_mul_pd(az, by)));
+        _mm256_storeu_pd(dest->y + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(ay, bw), _mm256_mul_pd(aw, by)), _mm256_mul_pd(az, bx)), _mm256_mul_pd(ax, bz)));
+        _mm256_storeu_pd(dest->z + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(az, bw), _mm256_mul_pd(aw, bz)), _mm256_mul_pd(ax, by)), _mm256_mul_pd(ay, bx)));
+        _mm256_storeu_pd(dest->w + i, _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(
+            _mm256_mul_pd(aw, bw), _mm256_mul_pd(ax, bx)), _mm256_mul_pd(ay, by)), _mm256_mul_pd(az, bz)));
+    }
+
+    if (i < count) {
+        quat_soa_t a = quat_soa_at(quat, i), b = quat_soa_at(quat2, i), d = quat_soa_at(dest, i);
+        quat_multiply_n_scalar(&a, &b, &d, count - i);
+    }
+}
+
+AVX_TARGET void quat_normalize_n_avx(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count) {
+    __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+    unsigned int i;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m256d x = _mm256_loadu_pd(quat->x + i), y = _mm256_loadu_pd(quat->y + i),
+            z = _mm256_loadu_pd(quat->z + i), w = _mm256_loadu_pd(quat->w + i),
+            len = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+                _mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)), _mm256_mul_pd(w, w))),
+            isZero = _mm256_cmp_pd(len, zero, _CMP_EQ_OQ),
+            inv = _mm256_div_pd(one, len);
+
+        // Zero-length quaternions come out as zero, not NaN
+        _mm256_storeu_pd(dest->x + i, _mm256_andnot_pd(isZero, _mm256_mul_pd(x, inv)));
+        _mm256_storeu_pd(dest->y + i, _mm256_andnot_pd(isZero, _mm256_mul_pd(y, inv)));
+        _mm256_storeu_pd(dest->z + i, _mm256_andnot_pd(isZero, _mm256_mul_pd(z, inv)));
+        _mm256_storeu_pd(dest->w + i, _mm256_andnot_pd(isZero, _mm256_mul_pd(w, inv)));
+    }
+
+    if (i < count) {
+        quat_soa_t a = quat_soa_at(quat, i), d = quat_soa_at(dest, i);
+        quat_normalize_n_scalar(&a, &d, count - i);
+    }
+}
+
+AVX_TARGET void quat_slerp_n_avx(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count) {
+    unsigned int i;
+    int k;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m256d ax = _mm256_loadu_pd(quat->x + i), ay = _mm256_loadu_pd(quat->y + i),
+            az = _mm256_loadu_pd(quat->z + i), aw = _mm256_loadu_pd(quat->w + i),
+            bx = _mm256_loadu_pd(quat2->x + i), by = _mm256_loadu_pd(quat2->y + i),
+            bz = _mm256_loadu_pd(quat2->z + i), bw = _mm256_loadu_pd(quat2->w + i),
+            rA, rB, copy;
+        double cosHalfTheta[4], ratioA[4], ratioB[4], same[4];
+
+        _mm256_storeu_pd(cosHalfTheta, _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(ax, bx), _mm256_mul_pd(ay, by)), _mm256_mul_pd(az, bz)), _mm256_mul_pd(aw, bw)));
+
+        // The ratios need acos/sin, so they are worked out lane by lane as in quat_slerp
+        for (k = 0; k < 4; k++) {
+            double c = cosHalfTheta[k], t = slerp[i + k];
+
+            same[k] = 0;
+            if (fabs(c) >= 1.0) {
+                same[k] = 1;
+                ratioA[k] = ratioB[k] = 0;
+            } else {
+                double halfTheta = acos(c),
+                    sinHalfTheta = sqrt(1.0 - c * c);
+
+                if (fabs(sinHalfTheta) < 0.001) {
+                    ratioA[k] = 1 - t;
+                    ratioB[k] = t;
+                } else {
+                    ratioA[k] = sin((1 - t) * halfTheta) / sinHalfTheta;
+                    ratioB[k] = sin(t * halfTheta) / sinHalfTheta;
+                }
+            }
+        }
+
+        rA = _mm256_loadu_pd(ratioA);
+        rB = _mm256_loadu_pd(ratioB);
+        copy = _mm256_cmp_pd(_mm256_loadu_pd(same), _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+
+        _mm256_storeu_pd(dest->x + i, _mm256_blendv_pd(_mm256_add_pd(_mm256_mul_pd(ax, rA), _mm256_mul_pd(bx, rB)), ax, copy));
+        _mm256_storeu_pd(dest->y + i, _mm256_blendv_pd(_mm256_add_pd(_mm256_mul_pd(ay, rA), _mm256_mul_pd(by, rB)), ay, copy));
+        _mm256_storeu_pd(dest->z + i, _mm256_blendv_pd(_mm256_add_pd(_mm256_mul_pd(az, rA), _mm256_mul_pd(bz, rB)), az, copy));
+        _mm256_storeu_pd(dest->w + i, _mm256_blendv_pd(_mm256_add_pd(_mm256_mul_pd(aw, rA), _mm256_mul_pd(bw, rB)), aw, copy));
+    }
+
+    if (i < count) {
+        quat_soa_t a = quat_soa_at(quat, i), b = quat_soa_at(quat2, i), d = quat_soa_at(dest, i);
+        quat_slerp_n_scalar(&a, &b, slerp + i, &d, count - i);
+    }
+}
+
+AVX_TARGET void quat_rotate_vec3_n_avx(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m256d qx = _mm256_loadu_pd(quat->x + i), qy = _mm256_loadu_pd(quat->y + i),
+            qz = _mm256_loadu_pd(quat->z + i), qw = _mm256_loadu_pd(quat->w + i),
+            x = _mm256_loadu_pd(vec->x + i), y = _mm256_loadu_pd(vec->y + i), z = _mm256_loadu_pd(vec->z + i),
+            nqx = avx_neg(qx), nqy = avx_neg(qy), nqz = avx_neg(qz),
+
+            // quat * vec
+            ix = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(qw, x), _mm256_mul_pd(qy, z)), _mm256_mul_pd(qz, y)),
+            iy = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(qw, y), _mm256_mul_pd(qz, x)), _mm256_mul_pd(qx, z)),
+            iz = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(qw, z), _mm256_mul_pd(qx, y)), _mm256_mul_pd(qy, x)),
+            iw = _mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(nqx, x), _mm256_mul_pd(qy, y)), _mm256_mul_pd(qz, z));
+
+        // result * inverse quat
+        _mm256_storeu_pd(dest->x + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(ix, qw), _mm256_mul_pd(iw, nqx)), _mm256_mul_pd(iy, nqz)), _mm256_mul_pd(iz, nqy)));
+        _mm256_storeu_pd(dest->y + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(iy, qw), _mm256_mul_pd(iw, nqy)), _mm256_mul_pd(iz, nqx)), _mm256_mul_pd(ix, nqz)));
+        _mm256_storeu_pd(dest->z + i, _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(iz, qw), _mm256_mul_pd(iw, nqz)), _mm256_mul_pd(ix, nqy)), _mm256_mul_pd(iy, nqx)));
+    }
+
+    if (i < count) {
+        quat_soa_t q = quat_soa_at(quat, i);
+        vec3_soa_t v = vec3_soa_at(vec, i), d = vec3_soa_at(dest, i);
+        quat_rotate_vec3_n_scalar(&q, &v, &d, count - i);
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "gl_matrix.h"
+#include "simd.h"
+
+/*
+ * Kernel selection.  The best set the CPU supports is chosen when the
+ * library loads; the GL_MATRIX_SIMD environment variable, or
+ * gl_matrix_setSimdPath(), can force "scalar", "sse2", "avx" or "neon" for
+ * comparison.  Sets may share kernels where a wider one doesn't pay off.
+ */
+
+static const gl_matrix_kernels_t gl_matrix_kernels_scalar = {
+    "scalar",
+    mat4_multiply_scalar,
+    mat4_inverse_scalar,
+    mat4_transformVec3Array_scalar,
+    quat_multiply_n_scalar,
+    quat_normalize_n_scalar,
+    quat_slerp_n_scalar,
+    quat_rotate_vec3_n_scalar
+};
+
+const gl_matrix_kernels_t *gl_matrix_kernels = &gl_matrix_kernels_scalar;
+
+#ifdef GL_MATRIX_HAVE_V2
+static const gl_matrix_kernels_t gl_matrix_kernels_v2 = {
+#if defined(__aarch64__)
+    "neon",
+#else
+    "sse2",
+#endif
+    mat4_multiply_v2,
+    mat4_inverse_v2,
+    mat4_transformVec3Array_v2,
+    quat_multiply_n_scalar,
+    quat_normalize_n_scalar,
+    quat_slerp_n_scalar,
+    quat_rotate_vec3_n_scalar
+};
+#endif
+
+#ifdef GL_MATRIX_HAVE_AVX
+static const gl_matrix_kernels_t gl_matrix_kernels_avx = {
+    "avx",
+    mat4_multiply_avx,
+    mat4_inverse_v2,    // Gathering 4-wide operands costs more than it saves
+    mat4_transformVec3Array_avx,
+    quat_multiply_n_avx,
+    quat_normalize_n_avx,
+    quat_slerp_n_avx,
+    quat_rotate_vec3_n_avx
+};
+#endif
+
+/* In order of preference */
+static const gl_matrix_kernels_t *gl_matrix_kernelSets[] = {
+#ifdef GL_MATRIX_HAVE_AVX
+    &gl_matrix_kernels_avx,
+#endif
+#ifdef GL_MATRIX_HAVE_V2
+    &gl_matrix_kernels_v2,
+#endif
+    &gl_matrix_kernels_scalar,
+    NULL
+};
+
+static int gl_matrix_supported(const gl_matrix_kernels_t *k) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (!strcmp(k->name, "avx")) { return __builtin_cpu_supports("avx"); }
+    if (!strcmp(k->name, "sse2")) { return __builtin_cpu_supports("sse2"); }
+#endif
+    return 1;
+}
+
+const char *gl_matrix_simdPath(void) {
+    return gl_matrix_kernels->name;
+}
+
+int gl_matrix_setSimdPath(const char *name) {
+    int i;
+
+    for (i = 0; gl_matrix_kernelSets[i]; i++) {
+        const gl_matrix_kernels_t *k = gl_matrix_kernelSets[i];
+
+        if ((!name || !strcmp(name, k->name)) && gl_matrix_supported(k)) {
+            gl_matrix_kernels = k;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void __attribute__((constructor)) gl_matrix_selectKernels(void) {
+    const char *env = getenv("GL_MATRIX_SIMD");
+
+    if (!env || !gl_matrix_setSimdPath(env)) {
+        gl_matrix_setSimdPath(NULL);
+    }
+}
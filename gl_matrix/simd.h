@@ -0,0 +1,61 @@
+#ifndef GL_MATRIX_SIMD_H
+#define GL_MATRIX_SIMD_H
+
+#include "gl_matrix.h"
+
+/*
+ * Private to gl_matrix: the kernel table behind mat4_multiply, mat4_inverse,
+ * mat4_transformVec3Array and the quat_*_n batch functions.  Kernels take
+ * plain pointers and dest may alias any input (element for element).
+ * inverse returns 0 without touching dest when the matrix is singular.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GL_MATRIX_HAVE_V2
+#define GL_MATRIX_HAVE_AVX
+#define AVX_TARGET __attribute__((target("avx")))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define GL_MATRIX_HAVE_V2
+#endif
+
+typedef struct {
+    const char *name;
+
+    void (*multiply)(const double *mat, const double *mat2, double *dest);
+    int (*inverse)(const double *mat, double *dest);
+    void (*transformVec3Array)(const double *mat, const double *vecs, unsigned int count, double *dest);
+
+    void (*quatMultiply)(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count);
+    void (*quatNormalize)(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count);
+    void (*quatSlerp)(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count);
+    void (*quatRotateVec3)(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count);
+} gl_matrix_kernels_t;
+
+extern const gl_matrix_kernels_t *gl_matrix_kernels;
+
+void mat4_multiply_scalar(const double *mat, const double *mat2, double *dest);
+int mat4_inverse_scalar(const double *mat, double *dest);
+void mat4_transformVec3Array_scalar(const double *mat, const double *vecs, unsigned int count, double *dest);
+
+void quat_multiply_n_scalar(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count);
+void quat_normalize_n_scalar(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count);
+void quat_slerp_n_scalar(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count);
+void quat_rotate_vec3_n_scalar(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count);
+
+#ifdef GL_MATRIX_HAVE_V2
+void mat4_multiply_v2(const double *mat, const double *mat2, double *dest);
+int mat4_inverse_v2(const double *mat, double *dest);
+void mat4_transformVec3Array_v2(const double *mat, const double *vecs, unsigned int count, double *dest);
+#endif
+
+#ifdef GL_MATRIX_HAVE_AVX
+void mat4_multiply_avx(const double *mat, const double *mat2, double *dest);
+void mat4_transformVec3Array_avx(const double *mat, const double *vecs, unsigned int count, double *dest);
+
+void quat_multiply_n_avx(const quat_soa_t *quat, const quat_soa_t *quat2, const quat_soa_t *dest, unsigned int count);
+void quat_normalize_n_avx(const quat_soa_t *quat, const quat_soa_t *dest, unsigned int count);
+void quat_slerp_n_avx(const quat_soa_t *quat, const quat_soa_t *quat2, const double *slerp, const quat_soa_t *dest, unsigned int count);
+void quat_rotate_vec3_n_avx(const quat_soa_t *quat, const vec3_soa_t *vec, const vec3_soa_t *dest, unsigned int count);
+#endif
+
+#endif
@@ -2,9 +2,10 @@
 #include <math.h>
 
 #include "gl_matrix.h"
+#include "alloc.h"
 
 vec3_t vec3_create(vec3_t vec) {
-    vec3_t dest = calloc(sizeof(double_t), 3);
+    vec3_t dest = gl_matrix_alloc(3);
 
     if (vec) {
         dest[0] = vec[0];
@@ -180,8 +181,7 @@ double vec3_dist(vec3_t vec, vec3_t vec2) {
 vec3_t vec3_unproject(vec3_t vec, mat4_t view, mat4_t proj, vec4_t viewport, vec3_t dest) {
     if (!dest) { dest = vec; }
 
-    mat4_t m = mat4_create(NULL);
-    double *v = malloc(sizeof(double) * 4);
+    double m[16], v[4];
     
     v[0] = (vec[0] - viewport[0]) * 2.0 / viewport[2] - 1.0;
     v[1] = (vec[1] - viewport[1]) * 2.0 / viewport[3] - 1.0;
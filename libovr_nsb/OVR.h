@@ -2,6 +2,10 @@
 #define _OVR_H_
 
 #include <libovr_nsb/OVR_Sensor.h>
+#include <libovr_nsb/OVR_PoseHistory.h>
+#include <libovr_nsb/OVR_DeviceGroup.h>
+#include <libovr_nsb/OVR_PoseShm.h>
+#include <libovr_nsb/OVR_PoseStream.h>
 
 // Open the nthDevice Rift attached to the system, in the order they
 // appear in /dev's dirent.
@@ -10,6 +14,10 @@
 //         NULL on failure
 Device * openRift( int nthDevice, Device *myDev );
 
+// Close a device opened with openRift.  The Device struct itself is not
+// freed; free() it if openRift allocated it.
+void closeRift( Device *dev );
+
 // Attempt to process one device sample
 // Should be called as frequently as possible
 //
@@ -28,4 +36,16 @@ BOOLEAN waitSampleDevice(Device *dev, UInt16 waitMsec);
 // Return: TRUE if keepalive was successful
 BOOLEAN sendSensorKeepAlive(Device *dev);
 
+// Register a function to be called on the sampling thread for every fused
+// sample, including samples replicated to cover dropped reports.
+// Listeners must be added or removed while the device is not being sampled.
+//
+// Return: TRUE if the listener was added
+BOOLEAN addSampleListener(Device *dev, SampleListenerFunc func, void *userData);
+
+// Unregister a listener added with the same func and userData
+//
+// Return: TRUE if the listener was found
+BOOLEAN removeSampleListener(Device *dev, SampleListenerFunc func, void *userData);
+
 #endif
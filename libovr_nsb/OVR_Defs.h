@@ -35,6 +35,20 @@ UInt32 DecodeUInt32(const UByte* buffer);
 float DecodeFloat(const UByte* buffer);
 void vec3_clear(vec3_t v);
 double vec3_angle(vec3_t v1, vec3_t v2);
+
+// A value that increases with the angle between v1 and v2, for comparing
+// angles: -cos(angle) when built with OVR_FAST_TRIG, which avoids acos,
+// otherwise the angle itself.
+double vec3_angleKey(vec3_t v1, vec3_t v2);
+
+// Largest |x| smallAngleSinCos evaluates with its polynomial
+#define SMALL_ANGLE_MAX 0.1
+
+// sin(x) and cos(x).  Within SMALL_ANGLE_MAX this is a short polynomial,
+// within a couple of ulp of libm; larger angles call sin/cos.
+void smallAngleSinCos(double x, double *s, double *c);
+// Rotate v by q.  A NULL result rotates v in place.
 vec3_t quat_rotate(quat_t q, vec3_t v, vec3_t result);
+double getHostTime(void);
 
 #endif
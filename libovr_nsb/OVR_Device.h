@@ -68,9 +68,29 @@ typedef struct
 } SensorDisplayInfo;
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-// Device struct
+// Sample listeners
+// Called on the sampling thread after each sensor sample is fused, with the
+// sample and the resulting orientation.  Both pointers are only valid for
+// the duration of the call.
 //////////////////////////////////////////////////////////////////////////////////////////////
+#define MAX_SAMPLE_LISTENERS 4
+
+struct Device;
+struct MessageBodyFrame;
+
+typedef void (*SampleListenerFunc)(struct Device *dev, const struct MessageBodyFrame *msg,
+                                   const double *Q, void *userData);
+
 typedef struct
+{
+    SampleListenerFunc Func;
+    void              *UserData;
+} SampleListener;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Device struct
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct Device
 {
     int               fd;
     char              *devicePath;
@@ -120,6 +140,10 @@ typedef struct
 
 	// Testing AngV filtering suggested by Steve
 	double		      AngVFilterHistory[8][3]; // vec3_t
+
+    // Registered sample listeners
+    SampleListener    Listeners[MAX_SAMPLE_LISTENERS];
+    int               NumListeners;
 } Device;
 
 #endif
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+
+#include <pthread.h>
+
+#include <libovr_nsb/OVR.h>
+#include <libovr_nsb/OVR_HID.h>
+#include <libovr_nsb/OVR_DeviceGroup.h>
+
+// Upper bound on reports drained from one device before moving to the next,
+// so a single busy device can't starve the others
+#define MAX_DRAIN_PER_PASS 16
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+DeviceGroup * createDeviceGroup( DeviceGroup *myGroup )
+{
+    DeviceGroup *group = myGroup;
+
+    if (! group )
+    {
+        group = (DeviceGroup *)malloc(sizeof(DeviceGroup));
+        if (! group )
+        {
+            return 0;
+        }
+    }
+
+    memset(group, 0, sizeof(DeviceGroup));
+    group->IdleWaitMs = 1;
+    group->HistorySize = POSE_HISTORY_DEFAULT_SIZE;
+    return group;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void destroyDeviceGroup( DeviceGroup *group )
+{
+    stopDeviceGroup(group);
+
+    int i;
+    for (i = 0; i < group->NumDevices; i++)
+    {
+        freePoseHistory(&group->History[i]);
+    }
+    group->NumDevices = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+int addGroupDevice( DeviceGroup *group, Device *dev )
+{
+    if (group->runSampleThread || group->NumDevices >= DEVICE_GROUP_MAX_DEVICES)
+    {
+        return -1;
+    }
+    if (! initPoseHistory(&group->History[group->NumDevices], group->HistorySize) )
+    {
+        return -1;
+    }
+
+    dev->NextKeepAliveTicks = 0;
+    group->Devices[group->NumDevices] = dev;
+    return group->NumDevices++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Send a keepalive when the device is halfway through its interval
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void serviceKeepAlive( Device *dev, double now )
+{
+    UInt64 ticksMs = (UInt64)(now * 1000.0);
+
+    if (ticksMs >= dev->NextKeepAliveTicks)
+    {
+        sendSensorKeepAlive(dev);
+        dev->NextKeepAliveTicks = ticksMs + dev->keepAliveIntervalMs / 2;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Sampler thread.  Drains whatever each device has queued without blocking;
+// only when every device came up empty do we block, briefly, on one of them.
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void *groupThreadFunc( void *data )
+{
+    DeviceGroup *group = (DeviceGroup *)data;
+    int waitIndex = 0;
+    UInt8 buf[256];
+
+    while( group->runSampleThread )
+    {
+        BOOLEAN gotSample = FALSE;
+        double  now = getHostTime();
+
+        int i;
+        for (i = 0; i < group->NumDevices; i++)
+        {
+            Device *dev = group->Devices[i];
+
+            int n;
+            for (n = 0; n < MAX_DRAIN_PER_PASS; n++)
+            {
+                int res = readSample(dev, buf, sizeof(buf));
+                if (res <= 0)
+                {
+                    break;
+                }
+                processSample(dev, buf, res);
+                pushPoseHistory(&group->History[i], getHostTime(), dev->Q, dev->AngV);
+                gotSample = TRUE;
+            }
+
+            serviceKeepAlive(dev, now);
+        }
+
+        if (!gotSample && group->NumDevices > 0)
+        {
+            // Rotate which device we park on so none waits more than IdleWaitMs
+            waitIndex = (waitIndex + 1) % group->NumDevices;
+            Device *dev = group->Devices[waitIndex];
+
+            int res = waitForSample(dev, group->IdleWaitMs, buf, sizeof(buf));
+            if (res > 0)
+            {
+                processSample(dev, buf, res);
+                pushPoseHistory(&group->History[waitIndex], getHostTime(), dev->Q, dev->AngV);
+            }
+        }
+    }
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN startDeviceGroup( DeviceGroup *group )
+{
+    if (group->runSampleThread)
+    {
+        return FALSE;
+    }
+
+    group->runSampleThread = TRUE;
+    if (pthread_create(&group->SampleThread, NULL, groupThreadFunc, group) != 0)
+    {
+        group->runSampleThread = FALSE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void stopDeviceGroup( DeviceGroup *group )
+{
+    if (group->runSampleThread)
+    {
+        group->runSampleThread = FALSE;
+        pthread_join(group->SampleThread, NULL);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN getGroupPoseAtTime( DeviceGroup *group, int index, double time, quat_t out )
+{
+    PoseHistory *h = getGroupPoseHistory(group, index);
+    PoseSample  s;
+
+    if (! h || ! getPoseHistoryAt(h, time, &s) )
+    {
+        return FALSE;
+    }
+    quat_set(s.Q, out);
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+PoseHistory * getGroupPoseHistory( DeviceGroup *group, int index )
+{
+    if (index < 0 || index >= group->NumDevices)
+    {
+        return 0;
+    }
+    return &group->History[index];
+}
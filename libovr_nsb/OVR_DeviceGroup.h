@@ -0,0 +1,71 @@
+#if !defined(_OVR_DEVICEGROUP_H)
+#define _OVR_DEVICEGROUP_H
+
+#include <pthread.h>
+
+#include <gl_matrix/gl_matrix.h>
+
+#include <libovr_nsb/OVR_Defs.h>
+#include <libovr_nsb/OVR_Device.h>
+#include <libovr_nsb/OVR_PoseHistory.h>
+
+// Most trackers we expect to service from a single sampler thread
+#define DEVICE_GROUP_MAX_DEVICES 8
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// DeviceGroup struct
+// One sampler thread servicing several devices, each with its own pose history
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    Device            *Devices[DEVICE_GROUP_MAX_DEVICES];
+    PoseHistory       History[DEVICE_GROUP_MAX_DEVICES];
+    int               NumDevices;
+
+    // Samples of history kept for each device added after this is set
+    UInt32            HistorySize;
+
+    // How long the sampler blocks on a device when no device had data
+    UInt16            IdleWaitMs;
+
+    pthread_t         SampleThread;
+    volatile BOOLEAN  runSampleThread;
+} DeviceGroup;
+
+// Initialize a device group.  If myGroup is NULL, storage is allocated.
+//
+// Return: Initialized group
+//         NULL on failure
+DeviceGroup * createDeviceGroup( DeviceGroup *myGroup );
+
+// Stop the sampler thread if running and release group resources.
+// Devices and group storage are left to the caller.
+void destroyDeviceGroup( DeviceGroup *group );
+
+// Add an opened device to the group and allocate its pose history.
+// Must be called before startDeviceGroup.
+//
+// Return: Index of the device in the group
+//         -1 on failure
+int addGroupDevice( DeviceGroup *group, Device *dev );
+
+// Start the sampler thread.  Keepalives are sent on each device's
+// keepalive interval.
+//
+// Return: TRUE if the thread was started
+BOOLEAN startDeviceGroup( DeviceGroup *group );
+
+// Signal the sampler thread to exit and wait for it
+void stopDeviceGroup( DeviceGroup *group );
+
+// Get the orientation of the nth device in the group at host time 'time',
+// interpolated between the two nearest samples.  Times outside the history
+// are clamped to the oldest or newest sample.
+//
+// Return: TRUE if the history had a sample to report
+BOOLEAN getGroupPoseAtTime( DeviceGroup *group, int index, double time, quat_t out );
+
+// Direct access to the nth device's history
+PoseHistory * getGroupPoseHistory( DeviceGroup *group, int index );
+
+#endif
@@ -116,7 +116,15 @@ Device * openRiftHID( int nthDevice, Device *myDev )
 /////////////////////////////////////////////////////////////////////////////////////////////
 void closeRiftHID( Device *myDev )
 {
-    // TODO - clean up device
+    if( myDev->hidapi_dev )
+    {
+        hid_close(myDev->hidapi_dev);
+        myDev->hidapi_dev = 0;
+    }
+    free(myDev->name);
+    free(myDev->product);
+    free(myDev->serial);
+    myDev->name = myDev->product = myDev->serial = 0;
     hid_exit();
 }
 
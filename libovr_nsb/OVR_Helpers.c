@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <math.h>
+#include <time.h>
 
 #include <gl_matrix/gl_matrix.h>
 
@@ -46,6 +47,32 @@ double vec3_angle(vec3_t v1, vec3_t v2)
     return acos(vec3_dot(v1,v2) / (vec3_length(v1)*vec3_length(v2)));
 }
 
+double vec3_angleKey(vec3_t v1, vec3_t v2)
+{
+#ifdef OVR_FAST_TRIG
+    // acos is decreasing, so -cos orders angles the same way
+    return -vec3_dot(v1,v2) / (vec3_length(v1)*vec3_length(v2));
+#else
+    return vec3_angle(v1,v2);
+#endif
+}
+
+void smallAngleSinCos(double x, double *s, double *c)
+{
+    if (fabs(x) > SMALL_ANGLE_MAX)
+    {
+        *s = sin(x);
+        *c = cos(x);
+        return;
+    }
+
+    // Taylor series through x^9 and x^8; the first dropped terms are
+    // below 3e-17 for |x| <= 0.1
+    double x2 = x * x;
+    *s = x * (1.0 - x2 * (1.0 / 6 - x2 * (1.0 / 120 - x2 * (1.0 / 5040 - x2 * (1.0 / 362880)))));
+    *c = 1.0 - x2 * (0.5 - x2 * (1.0 / 24 - x2 * (1.0 / 720 - x2 * (1.0 / 40320))));
+}
+
 vec3_t quat_rotate(quat_t q, vec3_t v, vec3_t result)
 {
     double qbuf1[4];
@@ -58,7 +85,7 @@ vec3_t quat_rotate(quat_t q, vec3_t v, vec3_t result)
 
     if( result == 0 )
     {
-        result = vec3_create(0);
+        result = v;
     }
     temp[_X_] = v[_X_];
     temp[_Y_] = v[_Y_];
@@ -76,3 +103,12 @@ vec3_t quat_rotate(quat_t q, vec3_t v, vec3_t result)
 }
 
 
+
+// Monotonic host time in seconds, used to stamp fused samples
+double getHostTime(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+
+#include <libovr_nsb/OVR_PoseHistory.h>
+
+// Give up and report failure if a reader keeps losing races with the writer
+#define MAX_READ_RETRIES 8
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN initPoseHistory( PoseHistory *h, UInt32 size )
+{
+    UInt32 pow2 = 1;
+
+    if (size == 0)
+    {
+        size = POSE_HISTORY_DEFAULT_SIZE;
+    }
+    while (pow2 < size)
+    {
+        pow2 <<= 1;
+    }
+
+    h->Slots = (PoseHistorySlot *)calloc(pow2, sizeof(PoseHistorySlot));
+    if (! h->Slots )
+    {
+        return FALSE;
+    }
+    h->Size = pow2;
+    h->Mask = pow2 - 1;
+    h->WriteCount = 0;
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void freePoseHistory( PoseHistory *h )
+{
+    free(h->Slots);
+    h->Slots = 0;
+    h->Size = 0;
+    h->Mask = 0;
+    h->WriteCount = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Seqlock-style write of one slot
+/////////////////////////////////////////////////////////////////////////////////////////////
+void writePoseSlot( PoseHistorySlot *slot, UInt64 index, double time, quat_t q, vec3_t angV )
+{
+    __atomic_store_n(&slot->Seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->Sample.Time = time;
+    quat_set(q, slot->Sample.Q);
+    vec3_set(angV, slot->Sample.AngV);
+
+    __atomic_store_n(&slot->Seq, index + 1, __ATOMIC_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Copy the sample with absolute index 'index'.  Fails if the writer has
+// overwritten (or is overwriting) that slot.
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN readPoseSlot( PoseHistorySlot *slot, UInt64 index, PoseSample *out )
+{
+    if (__atomic_load_n(&slot->Seq, __ATOMIC_ACQUIRE) != index + 1)
+    {
+        return FALSE;
+    }
+    memcpy(out, (const void *)&slot->Sample, sizeof(PoseSample));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&slot->Seq, __ATOMIC_RELAXED) == index + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void pushPoseHistory( PoseHistory *h, double time, quat_t q, vec3_t angV )
+{
+    UInt64 index = h->WriteCount;
+
+    writePoseSlot(&h->Slots[index & h->Mask], index, time, q, angV);
+    __atomic_store_n(&h->WriteCount, index + 1, __ATOMIC_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN findLatestPose( PoseHistorySlot *slots, UInt32 size, volatile UInt64 *writeCount,
+                        PoseSample *out )
+{
+    int retry;
+    for (retry = 0; retry < MAX_READ_RETRIES; retry++)
+    {
+        UInt64 count = __atomic_load_n(writeCount, __ATOMIC_ACQUIRE);
+        if (count == 0)
+        {
+            return FALSE;
+        }
+        if (readPoseSlot(&slots[(count - 1) & (size - 1)], count - 1, out))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN getLatestPose( PoseHistory *h, PoseSample *out )
+{
+    return findLatestPose(h->Slots, h->Size, &h->WriteCount, out);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// One lookup attempt against a snapshot of WriteCount.  Returns FALSE if any
+// probed slot was overwritten underneath us.
+/////////////////////////////////////////////////////////////////////////////////////////////
+static BOOLEAN tryPoseAt( PoseHistorySlot *slots, UInt32 size, volatile UInt64 *writeCount,
+                          double time, PoseSample *out, BOOLEAN *empty )
+{
+    UInt64 count = __atomic_load_n(writeCount, __ATOMIC_ACQUIRE);
+    UInt32 mask  = size - 1;
+    PoseSample a, b;
+
+    *empty = (count == 0);
+    if (count == 0)
+    {
+        return FALSE;
+    }
+
+    // The oldest slot is the next one to be overwritten, so leave it alone
+    UInt64 hi = count - 1;
+    UInt64 lo = (count > size) ? count - size + 1 : 0;
+
+    if (! readPoseSlot(&slots[hi & mask], hi, &b) )
+    {
+        return FALSE;
+    }
+    if (time >= b.Time || lo == hi)
+    {
+        *out = b;
+        return TRUE;
+    }
+
+    if (! readPoseSlot(&slots[lo & mask], lo, &a) )
+    {
+        return FALSE;
+    }
+    if (time <= a.Time)
+    {
+        *out = a;
+        return TRUE;
+    }
+
+    // Invariant: Time(lo) < time < Time(hi)
+    while (hi - lo > 1)
+    {
+        UInt64 mid = lo + (hi - lo) / 2;
+        PoseSample m;
+
+        if (! readPoseSlot(&slots[mid & mask], mid, &m) )
+        {
+            return FALSE;
+        }
+        if (m.Time <= time)
+        {
+            lo = mid;
+            a = m;
+        }
+        else
+        {
+            hi = mid;
+            b = m;
+        }
+    }
+
+    double span = b.Time - a.Time;
+    double t    = (span > 0) ? (time - a.Time) / span : 0;
+
+    out->Time = time;
+    quat_slerp(a.Q, b.Q, t, out->Q);
+    vec3_lerp(a.AngV, b.AngV, t, out->AngV);
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN findPoseAt( PoseHistorySlot *slots, UInt32 size, volatile UInt64 *writeCount,
+                    double time, PoseSample *out )
+{
+    int retry;
+    for (retry = 0; retry < MAX_READ_RETRIES; retry++)
+    {
+        BOOLEAN empty;
+
+        if (tryPoseAt(slots, size, writeCount, time, out, &empty))
+        {
+            return TRUE;
+        }
+        if (empty)
+        {
+            return FALSE;
+        }
+    }
+    return FALSE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN getPoseHistoryAt( PoseHistory *h, double time, PoseSample *out )
+{
+    return findPoseAt(h->Slots, h->Size, &h->WriteCount, time, out);
+}
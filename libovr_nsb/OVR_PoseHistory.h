@@ -0,0 +1,78 @@
+#if !defined(_OVR_POSEHISTORY_H)
+#define _OVR_POSEHISTORY_H
+
+#include <gl_matrix/gl_matrix.h>
+
+#include <libovr_nsb/OVR_Defs.h>
+
+// Default history length.  At 1kHz this is a little over half a second.
+#define POSE_HISTORY_DEFAULT_SIZE 512
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Timestamped pose
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    double            Time;    // Host time in seconds, see getHostTime()
+    double            Q[4];    // quat_t
+    double            AngV[3]; // vec3_t, rad/s
+} PoseSample;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// One ring entry.  Seq is index+1 of the sample held once it is complete,
+// and 0 while the writer is replacing it.
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    volatile UInt64   Seq;
+    PoseSample        Sample;
+} PoseHistorySlot;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// PoseHistory struct
+// Lock-free ring of past poses.  One thread pushes; any number of threads
+// may read concurrently.  Readers never block the writer: a reader that
+// races with a slot being overwritten simply retries.
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    PoseHistorySlot   *Slots;
+    UInt32            Size;       // Power of two
+    UInt32            Mask;
+    volatile UInt64   WriteCount; // Samples published so far
+} PoseHistory;
+
+// Allocate a history holding at least 'size' samples (rounded up to a power
+// of two).  A size of 0 selects POSE_HISTORY_DEFAULT_SIZE.
+//
+// Return: TRUE on success
+BOOLEAN initPoseHistory( PoseHistory *h, UInt32 size );
+
+// Release the slots.  No readers may be active.
+void freePoseHistory( PoseHistory *h );
+
+// Publish a pose.  Only one thread may push to a given history.
+void pushPoseHistory( PoseHistory *h, double time, quat_t q, vec3_t angV );
+
+// Copy the newest sample.
+//
+// Return: TRUE if the history had a sample to report
+BOOLEAN getLatestPose( PoseHistory *h, PoseSample *out );
+
+// Find the samples bracketing 'time' with a binary search and interpolate:
+// orientation through quat_slerp, angular velocity linearly.  Times outside
+// the history are clamped to the oldest or newest sample.
+//
+// Return: TRUE if the history had a sample to report
+BOOLEAN getPoseHistoryAt( PoseHistory *h, double time, PoseSample *out );
+
+// Low level slot functions, shared with rings that live outside a
+// PoseHistory (e.g. in shared memory).  'size' must be a power of two.
+void writePoseSlot( PoseHistorySlot *slot, UInt64 index, double time, quat_t q, vec3_t angV );
+BOOLEAN readPoseSlot( PoseHistorySlot *slot, UInt64 index, PoseSample *out );
+BOOLEAN findLatestPose( PoseHistorySlot *slots, UInt32 size, volatile UInt64 *writeCount,
+                        PoseSample *out );
+BOOLEAN findPoseAt( PoseHistorySlot *slots, UInt32 size, volatile UInt64 *writeCount,
+                    double time, PoseSample *out );
+
+#endif
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <libovr_nsb/OVR_PoseShm.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void setPoseShmName( PoseShm *shm, const char *name )
+{
+    if (! name )
+    {
+        name = POSE_SHM_DEFAULT_NAME;
+    }
+    strncpy(shm->Name, name, sizeof(shm->Name) - 1);
+    shm->Name[sizeof(shm->Name) - 1] = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+static BOOLEAN lockPoseShmName( PoseShm *shm )
+{
+    // The lock lives in its own object, never unlinked, so every server
+    // locks the same file whether or not the pose object exists yet.  The
+    // kernel drops the lock when its holder exits, however it exits.
+    char lockName[sizeof(shm->Name) + 8];
+    snprintf(lockName, sizeof(lockName), "%s.lock", shm->Name);
+
+    shm->LockFd = shm_open(lockName, O_RDWR | O_CREAT, 0644);
+    if (shm->LockFd < 0)
+    {
+        return FALSE;
+    }
+    if (flock(shm->LockFd, LOCK_EX | LOCK_NB) != 0)
+    {
+        if (errno == EWOULDBLOCK)
+        {
+            errno = EBUSY;
+        }
+        int err = errno;
+        close(shm->LockFd);
+        shm->LockFd = -1;
+        errno = err;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN createPoseShm( PoseShm *shm, const char *name )
+{
+    setPoseShmName(shm, name);
+    shm->Region = 0;
+    shm->Owner = FALSE;
+    shm->LockFd = -1;
+
+    // Held until closePoseShm, so while a server runs, from before its object
+    // exists until after it is gone, no other server can take the name.
+    if (!lockPoseShmName(shm))
+    {
+        return FALSE;
+    }
+
+    // Holding the lock, an existing object can only be a crashed server's
+    shm_unlink(shm->Name);
+    int fd = shm_open(shm->Name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        int err = errno;
+        closePoseShm(shm);
+        errno = err;
+        return FALSE;
+    }
+    shm->Owner = TRUE;
+
+    void *p = MAP_FAILED;
+    if (ftruncate(fd, sizeof(PoseShmRegion)) == 0)
+    {
+        p = mmap(0, sizeof(PoseShmRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        closePoseShm(shm);
+        return FALSE;
+    }
+
+    // The object is new, so clients that already had the name mapped keep
+    // the old one; fill in the header and only then advertise the layout
+    shm->Region = (PoseShmRegion *)p;
+    memset(shm->Region, 0, sizeof(PoseShmRegion));
+    shm->Region->Size = POSE_SHM_SIZE;
+    shm->Region->Version = POSE_SHM_VERSION;
+    shm->Region->ServerPid = getpid();
+    __atomic_store_n(&shm->Region->Magic, POSE_SHM_MAGIC, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void publishPoseShm( PoseShm *shm, double time, quat_t q, vec3_t angV )
+{
+    PoseShmRegion *r = shm->Region;
+    UInt64 index = r->WriteCount;
+
+    writePoseSlot(&r->Slots[index & (POSE_SHM_SIZE - 1)], index, time, q, angV);
+    __atomic_store_n(&r->WriteCount, index + 1, __ATOMIC_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN openPoseShm( PoseShm *shm, const char *name )
+{
+    setPoseShmName(shm, name);
+    shm->Region = 0;
+    shm->Owner = FALSE;
+    shm->LockFd = -1;
+
+    int fd = shm_open(shm->Name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return FALSE;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PoseShmRegion))
+    {
+        close(fd);
+        return FALSE;
+    }
+
+    void *p = mmap(0, sizeof(PoseShmRegion), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        return FALSE;
+    }
+
+    PoseShmRegion *r = (PoseShmRegion *)p;
+    if (__atomic_load_n(&r->Magic, __ATOMIC_ACQUIRE) != POSE_SHM_MAGIC ||
+        r->Version != POSE_SHM_VERSION || r->Size != POSE_SHM_SIZE)
+    {
+        munmap(p, sizeof(PoseShmRegion));
+        return FALSE;
+    }
+
+    shm->Region = r;
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void closePoseShm( PoseShm *shm )
+{
+    if (shm->Region)
+    {
+        munmap(shm->Region, sizeof(PoseShmRegion));
+        shm->Region = 0;
+    }
+    if (shm->Owner)
+    {
+        shm_unlink(shm->Name);
+        shm->Owner = FALSE;
+    }
+    // Only after the unlink, so the next server never sees this one's object
+    if (shm->LockFd >= 0)
+    {
+        close(shm->LockFd);
+        shm->LockFd = -1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN getPose( PoseShm *shm, PoseSample *out )
+{
+    PoseShmRegion *r = shm->Region;
+    return findLatestPose(r->Slots, POSE_SHM_SIZE, &r->WriteCount, out);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN getPoseAt( PoseShm *shm, double time, PoseSample *out )
+{
+    PoseShmRegion *r = shm->Region;
+    return findPoseAt(r->Slots, POSE_SHM_SIZE, &r->WriteCount, time, out);
+}
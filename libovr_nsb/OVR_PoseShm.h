@@ -0,0 +1,80 @@
+#if !defined(_OVR_POSESHM_H)
+#define _OVR_POSESHM_H
+
+#include <gl_matrix/gl_matrix.h>
+
+#include <libovr_nsb/OVR_Defs.h>
+#include <libovr_nsb/OVR_PoseHistory.h>
+
+// Default POSIX shared memory object the pose server publishes to
+#define POSE_SHM_DEFAULT_NAME "/libovr_nsb_pose"
+
+#define POSE_SHM_MAGIC   0x4f565250  // 'OVRP'
+#define POSE_SHM_VERSION 1
+
+// Poses kept in shared memory.  Must be a power of two.
+#define POSE_SHM_SIZE    1024
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Layout of the shared memory object.  Written only by the server; clients
+// map it read-only and use the same seqlock protocol as PoseHistory.
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    UInt32            Magic;
+    UInt32            Version;
+    UInt32            Size;
+    UInt32            ServerPid;
+    volatile UInt64   WriteCount;
+    PoseHistorySlot   Slots[POSE_SHM_SIZE];
+} PoseShmRegion;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// PoseShm struct - one process' handle on the region
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    PoseShmRegion     *Region;
+    BOOLEAN           Owner;
+    int               LockFd;       // Server: held locked while it runs
+    char              Name[64];
+} PoseShm;
+
+// Server: create the shared memory object and map it read/write.  name may
+// be NULL for POSE_SHM_DEFAULT_NAME.  The server holds an exclusive lock on
+// the object "<name>.lock", which is left in place, until closePoseShm or
+// exit.  An object left behind by a server that is no longer running is
+// replaced; while another server holds the lock, nothing is touched.
+//
+// Return: TRUE on success; FALSE with errno EBUSY if another server owns name
+BOOLEAN createPoseShm( PoseShm *shm, const char *name );
+
+// Server: publish a pose.  Only one process may publish.
+void publishPoseShm( PoseShm *shm, double time, quat_t q, vec3_t angV );
+
+// Client: map an existing shared memory object read-only.
+// name may be NULL for POSE_SHM_DEFAULT_NAME.
+//
+// A restarted server publishes into a new object, and a client keeps reading
+// the old one, which no longer changes, until it closes and opens again.
+// Clients that outlive the server should re-open when poses stop arriving,
+// or when Region->ServerPid no longer exists.
+//
+// Return: TRUE if the object exists and matches this library's layout
+BOOLEAN openPoseShm( PoseShm *shm, const char *name );
+
+// Unmap the region.  The server also removes the shared memory object.
+void closePoseShm( PoseShm *shm );
+
+// Client: copy the newest pose.  No system calls are made.
+//
+// Return: TRUE if the server has published a pose
+BOOLEAN getPose( PoseShm *shm, PoseSample *out );
+
+// Client: pose at host time 'time' (see getHostTime()), interpolated
+// as for getPoseHistoryAt.
+//
+// Return: TRUE if the server has published a pose
+BOOLEAN getPoseAt( PoseShm *shm, double time, PoseSample *out );
+
+#endif
@@ -0,0 +1,352 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <netdb.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <libovr_nsb/OVR_PoseStream.h>
+
+#define PACKET_HEADER_SIZE offsetof(PoseStreamPacket, Samples)
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void initSender( PoseStreamSender *s, UInt32 batchSize )
+{
+    memset(s, 0, sizeof(PoseStreamSender));
+    s->Fd = -1;
+
+    if (batchSize == 0)
+    {
+        batchSize = POSE_STREAM_DEFAULT_BATCH;
+    }
+    if (batchSize > POSE_STREAM_MAX_BATCH)
+    {
+        batchSize = POSE_STREAM_MAX_BATCH;
+    }
+    s->BatchSize = batchSize;
+    s->DatagramsPerSend = 1;
+
+    int i;
+    for (i = 0; i < POSE_STREAM_MAX_DATAGRAMS; i++)
+    {
+        s->Packets[i].Magic = POSE_STREAM_MAGIC;
+        s->Packets[i].Version = POSE_STREAM_VERSION;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Look up host:port as a datagram address
+/////////////////////////////////////////////////////////////////////////////////////////////
+static struct addrinfo *resolveUDP( const char *host, UInt16 port, int flags )
+{
+    struct addrinfo hints, *res = 0;
+    char portStr[8];
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = flags;
+    sprintf(portStr, "%u", port);
+
+    if (getaddrinfo(host, portStr, &hints, &res) != 0)
+    {
+        return 0;
+    }
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// The sender never blocks: if the receiver is slow or absent, datagrams are
+// dropped rather than stalling the sampling thread.
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN openPoseStreamUDP( PoseStreamSender *s, const char *host, UInt16 port, UInt32 batchSize )
+{
+    initSender(s, batchSize);
+
+    struct addrinfo *res = resolveUDP(host, port, 0);
+    if (! res )
+    {
+        return FALSE;
+    }
+
+    s->Fd = socket(res->ai_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    memcpy(&s->Addr, res->ai_addr, res->ai_addrlen);
+    s->AddrLen = res->ai_addrlen;
+    freeaddrinfo(res);
+
+    return s->Fd >= 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN openPoseStreamUnix( PoseStreamSender *s, const char *path, UInt32 batchSize )
+{
+    struct sockaddr_un *addr = (struct sockaddr_un *)&s->Addr;
+
+    initSender(s, batchSize);
+    if (strlen(path) >= sizeof(addr->sun_path))
+    {
+        return FALSE;
+    }
+
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+    s->AddrLen = sizeof(struct sockaddr_un);
+
+    s->Fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    return s->Fd >= 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void streamPose( PoseStreamSender *s, double time, quat_t q, vec3_t angV )
+{
+    PoseStreamPacket *p = &s->Packets[s->NumPackets];
+
+    if (p->Count == 0)
+    {
+        p->Sequence = s->Sequence;
+    }
+
+    PoseSample *ps = &p->Samples[p->Count++];
+    ps->Time = time;
+    quat_set(q, ps->Q);
+    vec3_set(angV, ps->AngV);
+    s->Sequence++;
+
+    if (p->Count >= s->BatchSize)
+    {
+        s->NumPackets++;
+        if (s->NumPackets >= s->DatagramsPerSend || s->NumPackets >= POSE_STREAM_MAX_DATAGRAMS)
+        {
+            flushPoseStream(s);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+int flushPoseStream( PoseStreamSender *s )
+{
+    struct mmsghdr msgs[POSE_STREAM_MAX_DATAGRAMS];
+    struct iovec   iov[POSE_STREAM_MAX_DATAGRAMS];
+    UInt32 n = s->NumPackets;
+    UInt32 i;
+
+    // Include a partially filled datagram
+    if (n < POSE_STREAM_MAX_DATAGRAMS && s->Packets[n].Count > 0)
+    {
+        n++;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    memset(msgs, 0, n * sizeof(struct mmsghdr));
+    for (i = 0; i < n; i++)
+    {
+        iov[i].iov_base = &s->Packets[i];
+        iov[i].iov_len  = PACKET_HEADER_SIZE + s->Packets[i].Count * sizeof(PoseSample);
+        msgs[i].msg_hdr.msg_name    = &s->Addr;
+        msgs[i].msg_hdr.msg_namelen = s->AddrLen;
+        msgs[i].msg_hdr.msg_iov     = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+
+    int sent = 0;
+    while (sent < (int)n)
+    {
+        int res = sendmmsg(s->Fd, msgs + sent, n - sent, 0);
+        if (res < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Nobody listening, or the receiver is behind; drop the rest
+            s->SendErrors += n - sent;
+            break;
+        }
+        for (i = sent; i < (UInt32)(sent + res); i++)
+        {
+            s->SamplesSent += s->Packets[i].Count;
+        }
+        sent += res;
+    }
+    s->DatagramsSent += sent;
+
+    for (i = 0; i < n; i++)
+    {
+        s->Packets[i].Count = 0;
+    }
+    s->NumPackets = 0;
+
+    return (sent == 0) ? -1 : sent;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void closePoseStreamSender( PoseStreamSender *s )
+{
+    if (s->Fd >= 0)
+    {
+        flushPoseStream(s);
+        close(s->Fd);
+        s->Fd = -1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN bindPoseStreamUDP( PoseStreamReceiver *r, const char *host, UInt16 port )
+{
+    memset(r, 0, sizeof(PoseStreamReceiver));
+    r->Fd = -1;
+
+    struct addrinfo *res = resolveUDP(host ? host : "127.0.0.1", port, AI_PASSIVE);
+    if (! res )
+    {
+        return FALSE;
+    }
+
+    r->Fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (r->Fd < 0 || bind(r->Fd, res->ai_addr, res->ai_addrlen) != 0)
+    {
+        freeaddrinfo(res);
+        closePoseStreamReceiver(r);
+        return FALSE;
+    }
+    freeaddrinfo(res);
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN bindPoseStreamUnix( PoseStreamReceiver *r, const char *path )
+{
+    struct sockaddr_un addr;
+
+    memset(r, 0, sizeof(PoseStreamReceiver));
+    r->Fd = -1;
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        return FALSE;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    r->Fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (r->Fd < 0)
+    {
+        return FALSE;
+    }
+
+    unlink(path);
+    if (bind(r->Fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        closePoseStreamReceiver(r);
+        return FALSE;
+    }
+    strcpy(r->Path, path);
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Unpack one datagram into out, tracking sequence gaps
+/////////////////////////////////////////////////////////////////////////////////////////////
+static int unpackPacket( PoseStreamReceiver *r, const PoseStreamPacket *p, unsigned int len,
+                         PoseSample *out, int room )
+{
+    if (len < PACKET_HEADER_SIZE || p->Magic != POSE_STREAM_MAGIC ||
+        p->Version != POSE_STREAM_VERSION || p->Count > POSE_STREAM_MAX_BATCH ||
+        len < PACKET_HEADER_SIZE + p->Count * sizeof(PoseSample))
+    {
+        return 0;
+    }
+
+    // A sequence that goes backwards means the sender restarted; resync
+    if (r->DatagramsReceived > 0 && p->Sequence > r->NextSequence)
+    {
+        r->SamplesDropped += p->Sequence - r->NextSequence;
+    }
+    r->NextSequence = p->Sequence + p->Count;
+    r->DatagramsReceived++;
+
+    int n = (p->Count < room) ? p->Count : room;
+    memcpy(out, p->Samples, n * sizeof(PoseSample));
+    r->SamplesReceived += n;
+    r->SamplesDropped  += p->Count - n;
+    return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+int receivePoses( PoseStreamReceiver *r, PoseSample *out, int maxSamples, int timeoutMs )
+{
+    struct mmsghdr msgs[POSE_STREAM_MAX_DATAGRAMS];
+    struct iovec   iov[POSE_STREAM_MAX_DATAGRAMS];
+    int i;
+
+    if (timeoutMs != 0)
+    {
+        struct pollfd pfd;
+        pfd.fd = r->Fd;
+        pfd.events = POLLIN;
+
+        int res = poll(&pfd, 1, timeoutMs);
+        if (res <= 0)
+        {
+            return (res == 0 || errno == EINTR) ? 0 : -1;
+        }
+    }
+
+    memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < POSE_STREAM_MAX_DATAGRAMS; i++)
+    {
+        iov[i].iov_base = &r->Packets[i];
+        iov[i].iov_len  = sizeof(PoseStreamPacket);
+        msgs[i].msg_hdr.msg_iov    = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = recvmmsg(r->Fd, msgs, POSE_STREAM_MAX_DATAGRAMS, MSG_DONTWAIT, 0);
+    if (n < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    int count = 0;
+    for (i = 0; i < n; i++)
+    {
+        count += unpackPacket(r, &r->Packets[i], msgs[i].msg_len, out + count, maxSamples - count);
+    }
+    return count;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+void closePoseStreamReceiver( PoseStreamReceiver *r )
+{
+    if (r->Fd >= 0)
+    {
+        close(r->Fd);
+        r->Fd = -1;
+    }
+    if (r->Path[0])
+    {
+        unlink(r->Path);
+        r->Path[0] = 0;
+    }
+}
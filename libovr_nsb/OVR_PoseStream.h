@@ -0,0 +1,123 @@
+#if !defined(_OVR_POSESTREAM_H)
+#define _OVR_POSESTREAM_H
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <gl_matrix/gl_matrix.h>
+
+#include <libovr_nsb/OVR_Defs.h>
+#include <libovr_nsb/OVR_PoseHistory.h>
+
+// Pose streaming to other processes on the same host.  Samples are packed
+// several to a datagram, and datagrams are handed to the kernel several at
+// a time with sendmmsg/recvmmsg.  Samples are in native byte order and
+// stamped with getHostTime(), so both ends must share a host clock.
+
+#define POSE_STREAM_MAGIC         0x4f565253  // 'OVRS'
+#define POSE_STREAM_VERSION       1
+
+// Most samples packed into one datagram
+#define POSE_STREAM_MAX_BATCH     16
+
+// Most datagrams queued per sendmmsg/recvmmsg call
+#define POSE_STREAM_MAX_DATAGRAMS 8
+
+#define POSE_STREAM_DEFAULT_BATCH 4
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Datagram layout.  Only the first Count samples are sent.
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    UInt32            Magic;
+    UInt16            Version;
+    UInt16            Count;
+    UInt64            Sequence;   // Sequence number of Samples[0]
+    PoseSample        Samples[POSE_STREAM_MAX_BATCH];
+} PoseStreamPacket;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Sending end
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    int               Fd;
+    struct sockaddr_storage Addr;
+    socklen_t         AddrLen;
+
+    // Samples per datagram, up to POSE_STREAM_MAX_BATCH
+    UInt32            BatchSize;
+    // Full datagrams held back before a sendmmsg, up to POSE_STREAM_MAX_DATAGRAMS.
+    // 1 sends each datagram as soon as it fills.
+    UInt32            DatagramsPerSend;
+
+    PoseStreamPacket  Packets[POSE_STREAM_MAX_DATAGRAMS];
+    UInt32            NumPackets;  // Full packets waiting to be sent
+    UInt64            Sequence;    // Next sample sequence number
+
+    // Statistics
+    UInt64            DatagramsSent;
+    UInt64            SamplesSent;
+    UInt64            SendErrors;
+} PoseStreamSender;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Receiving end
+//////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    int               Fd;
+    char              Path[108];   // Unix socket path to remove on close
+
+    PoseStreamPacket  Packets[POSE_STREAM_MAX_DATAGRAMS];
+
+    UInt64            NextSequence;
+
+    // Statistics
+    UInt64            DatagramsReceived;
+    UInt64            SamplesReceived;
+    UInt64            SamplesDropped;  // Gaps in the sequence numbers
+} PoseStreamReceiver;
+
+// Open a sender to UDP host:port (normally 127.0.0.1).
+// batchSize of 0 selects POSE_STREAM_DEFAULT_BATCH.
+//
+// Return: TRUE on success
+BOOLEAN openPoseStreamUDP( PoseStreamSender *s, const char *host, UInt16 port, UInt32 batchSize );
+
+// Open a sender to the Unix datagram socket at path
+//
+// Return: TRUE on success
+BOOLEAN openPoseStreamUnix( PoseStreamSender *s, const char *path, UInt32 batchSize );
+
+// Queue a sample.  Datagrams go out once DatagramsPerSend of them are full.
+void streamPose( PoseStreamSender *s, double time, quat_t q, vec3_t angV );
+
+// Send everything queued, including a partially filled datagram
+//
+// Return: Number of datagrams sent, -1 on error
+int flushPoseStream( PoseStreamSender *s );
+
+void closePoseStreamSender( PoseStreamSender *s );
+
+// Bind a receiver to UDP host:port.  host may be NULL for loopback.
+//
+// Return: TRUE on success
+BOOLEAN bindPoseStreamUDP( PoseStreamReceiver *r, const char *host, UInt16 port );
+
+// Bind a receiver to a Unix datagram socket at path, replacing any stale socket
+//
+// Return: TRUE on success
+BOOLEAN bindPoseStreamUnix( PoseStreamReceiver *r, const char *path );
+
+// Wait up to timeoutMs (-1 forever, 0 poll) for datagrams and unpack as
+// many samples as fit in out.  Samples from a datagram that don't fit are
+// discarded and counted as dropped.
+//
+// Return: Number of samples written to out, -1 on error
+int receivePoses( PoseStreamReceiver *r, PoseSample *out, int maxSamples, int timeoutMs );
+
+void closePoseStreamReceiver( PoseStreamReceiver *r );
+
+#endif
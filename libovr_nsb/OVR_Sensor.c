@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <math.h>
+#include <assert.h>
 
 #include <pthread.h>
 #include <sys/epoll.h>
@@ -24,6 +25,13 @@ Device * openRift( int nthDevice, Device *myDev )
     return dev;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+void closeRift( Device *dev )
+{
+    closeRiftHID(dev);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Sensor reports data in the following coordinate system:
 // Accelerometer: 10^-4 m/s^2; X forward, Y right, Z Down.
@@ -107,6 +115,52 @@ void initDevice(Device *dev)
     dev->EnablePrediction = FALSE;
     dev->EnableGravity = TRUE;
     dev->Q[3] = 1.0;
+    dev->NumListeners = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+BOOLEAN addSampleListener(Device *dev, SampleListenerFunc func, void *userData)
+{
+    if (!func || dev->NumListeners >= MAX_SAMPLE_LISTENERS)
+    {
+        return FALSE;
+    }
+    dev->Listeners[dev->NumListeners].Func = func;
+    dev->Listeners[dev->NumListeners].UserData = userData;
+    dev->NumListeners++;
+    return TRUE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+BOOLEAN removeSampleListener(Device *dev, SampleListenerFunc func, void *userData)
+{
+    int i;
+    for (i = 0; i < dev->NumListeners; i++)
+    {
+        if (dev->Listeners[i].Func == func && dev->Listeners[i].UserData == userData)
+        {
+            // Keep the remaining listeners in registration order
+            memmove(&dev->Listeners[i], &dev->Listeners[i+1],
+                    (dev->NumListeners - i - 1) * sizeof(SampleListener));
+            dev->NumListeners--;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Hand the sample and the orientation it produced to each listener in place
+///////////////////////////////////////////////////////////////////////////////
+static void notifySampleListeners(Device *dev, const MessageBodyFrame *msg)
+{
+    int i;
+    for (i = 0; i < dev->NumListeners; i++)
+    {
+        dev->Listeners[i].Func(dev, msg, dev->Q, dev->Listeners[i].UserData);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -143,8 +197,8 @@ void processTrackerData(Device *dev, TrackerSensors *s)
             
             sensors.Temperature   = dev->LastTemperature;
 
-            // TODO - Send faked update to listener
             updateOrientation(dev, &sensors);
+            notifySampleListeners(dev, &sensors);
         }
     }
     else
@@ -184,6 +238,7 @@ void processTrackerData(Device *dev, TrackerSensors *s)
 
         // Update our orientation
         updateOrientation(dev, &sensors);
+        notifySampleListeners(dev, &sensors);
 
         // TimeDelta for the last two sample is always fixed.
         sensors.TimeDelta = timeUnit;
@@ -294,6 +349,13 @@ void GetSensorRange(SensorRange* r, struct SensorScaleRange *s)
     r->MaxMagneticField= s->MagScale * 0.001f;
 }
 
+// Per-sample rotations are tiny, so OVR_FAST_TRIG builds use a polynomial
+#ifdef OVR_FAST_TRIG
+#define SIN_COS(x, s, c) smallAngleSinCos(x, s, c)
+#else
+#define SIN_COS(x, s, c) (*(s) = sin(x), *(c) = cos(x))
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////
 void updateOrientation(Device *dev, MessageBodyFrame *msg)
@@ -327,12 +389,14 @@ void updateOrientation(Device *dev, MessageBodyFrame *msg)
     if (angle > 0.0f)
     {
         float halfa = angle * 0.5f;
-        float sina  = sin(halfa) / angle;
+        double sinHalfa, cosHalfa;
+        SIN_COS(halfa, &sinHalfa, &cosHalfa);
+        float sina  = sinHalfa / angle;
         double dQ[4]; // quat_t
         dQ[0] = dV[_X_]*sina;
         dQ[1] = dV[_Y_]*sina;
         dQ[2] = dV[_Z_]*sina;
-        dQ[3] = cos(halfa);
+        dQ[3] = cosHalfa;
         //quat_t dQ(dV[_X_]*sina, dV[_Y_]*sina, dV[_Z_]sina, cos(halfa));
         quat_multiply(dev->Q, dQ, 0);
         //dev->Q =  dev->Q * dQ;
@@ -355,11 +419,12 @@ void updateOrientation(Device *dev, MessageBodyFrame *msg)
                 double       dQP[4]; // quat_t
                 //dQP[3] = 1;
                 //quat_t       dQP(0, 0, 0, 1);
-                float       sinaP  = sin(halfaP);  
+                double      sinaP, cosaP;
+                SIN_COS(halfaP, &sinaP, &cosaP);
                 dQP[0] = axis[_X_]*sinaP;
                 dQP[1] = axis[_Y_]*sinaP;
                 dQP[2] = axis[_Z_]*sinaP;
-                dQP[3] = cos(halfaP);
+                dQP[3] = cosaP;
                 //dQP = quat_t(axis[_X_]*sinaP, axis[_Y_]*sinaP, axis[_Z_]*sinaP, cos(halfaP));
                 quat_multiply(dev->Q, dQP, dev->QP);
                 //dev->QP =  dev->Q * dQP;
@@ -415,12 +480,12 @@ void updateOrientation(Device *dev, MessageBodyFrame *msg)
         quat_normalize(q1,0);
         //quat_t    q1 = (qfeedback * dev->Q).Normalized();
 
-        float angle0 = vec3_angle(yUp,aw);
+        double angle0 = vec3_angleKey(yUp,aw);
         //float    angle0 = yUp.Angle(aw);
         
         double temp[3];
         quat_rotate(q1,dev->A,temp);
-        float angle1 = vec3_angle(yUp,temp);
+        double angle1 = vec3_angleKey(yUp,temp);
         //float    angle1 = yUp.Angle(q1.Rotate(dev->A));
 
         if (angle1 < angle0)
@@ -443,7 +508,7 @@ void updateOrientation(Device *dev, MessageBodyFrame *msg)
 
             double temp2[3];
             quat_rotate(q2,dev->A,temp2);
-            float angle2 = vec3_angle(yUp,temp2);
+            double angle2 = vec3_angleKey(yUp,temp2);
             //float    angle2 = yUp.Angle(q2.Rotate(dev->A));
 
             if (angle2 < angle0)
@@ -539,7 +604,7 @@ BOOLEAN waitSampleDevice(Device *dev, UInt16 waitMsec)
 /////////////////////////////////////////////////////////////////////////////////////
 // Read a single tracker info me
 /////////////////////////////////////////////////////////////////////////////////////
-BOOLEAN processSample(Device *dev, UInt8 *buf, UInt16 len )
+BOOLEAN processSample(Device *dev, UInt8 *buf, int len )
 {
     if (len <= 0) 
     {
@@ -552,7 +617,14 @@ BOOLEAN processSample(Device *dev, UInt8 *buf, UInt16 len )
             TrackerSensors sensorMsg;
             if( DecodeTracker((UByte *)buf,&sensorMsg, len) != TrackerMessage_SizeError )
             {
+#ifdef OVR_ASSERT_NO_ALLOC
+                // Fusion must not make gl_matrix allocate
+                unsigned long allocs = gl_matrix_allocCount();
+                processTrackerData(dev, &sensorMsg);
+                assert(gl_matrix_allocCount() == allocs);
+#else
                 processTrackerData(dev, &sensorMsg);
+#endif
             }
         }
     }
@@ -85,7 +85,7 @@ typedef struct
     SInt16	MagX, MagY, MagZ;
 } TrackerSensors;
 
-typedef struct 
+typedef struct MessageBodyFrame
 {
     double Acceleration[3];   // Acceleration in m/s^2.
     double RotationRate[3];   // Angular velocity in rad/s^2.
@@ -109,6 +109,6 @@ void processTrackerData(Device *dev, TrackerSensors *s);
 void updateOrientation(Device *dev, MessageBodyFrame *msg);
 void GetAngVFilterVal(Device *dev, vec3_t out);
 void ResetAngVFilter(Device *dev );
-BOOLEAN processSample(Device *dev, UInt8 *buf, UInt16 len );
+BOOLEAN processSample(Device *dev, UInt8 *buf, int len );
 
 #endif
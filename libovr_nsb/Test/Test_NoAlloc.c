@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libovr_nsb/OVR.h>
+
+// Sensor fusion and the per-frame math of glStereoRender must not make
+// gl_matrix allocate.  Built twice by "make check": against a heap build of
+// gl_matrix, and against an arena build (GL_MATRIX_ARENA), where results
+// gl_matrix creates itself must not reach the heap either.
+
+static int g_failures = 0;
+
+static void check( BOOLEAN condition, const char *what )
+{
+    if( !condition )
+    {
+        printf("FAILED: %s\n", what);
+        g_failures++;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// A 62 byte tracker report (report id 1) with sampleCount samples
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void makeReport( UInt8 *buf, UInt8 sampleCount, UInt16 timestamp )
+{
+    int i;
+
+    memset(buf, 0, 62);
+    buf[0] = 1;
+    buf[1] = sampleCount;
+    buf[2] = timestamp & 0xFF;
+    buf[3] = timestamp >> 8;
+
+    // Arbitrary but non-zero readings, so every fusion branch has work to do
+    for( i = 8; i < 62; i++ )
+    {
+        buf[i] = (UInt8)(i * 37 + timestamp * 11);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void testFusion( void )
+{
+    Device dev;
+    UInt8 buf[62];
+    UInt16 timestamp = 0;
+    int i;
+
+    memset(&dev, 0, sizeof(dev));
+    initDevice(&dev);
+    dev.EnablePrediction = TRUE;
+    dev.PredictionDT = 0.03f;
+
+    // The first report only starts the sequence
+    makeReport(buf, 1, timestamp);
+    processSample(&dev, buf, sizeof(buf));
+
+    unsigned long allocs = gl_matrix_allocCount();
+    for( i = 0; i < 1000; i++ )
+    {
+        // Some reports carry several samples, some follow a dropped one
+        UInt8 samples = (UInt8)(1 + i % 3);
+        timestamp += samples + ((i % 50) == 49);
+        makeReport(buf, samples, timestamp);
+        processSample(&dev, buf, sizeof(buf));
+    }
+    check(gl_matrix_allocCount() == allocs, "processSample does not allocate");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// The gl_matrix calls glStereoRender makes for each eye, all with a dest
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void testFrameMath( void )
+{
+    double q[4] = { 0.1, 0.2, 0.3, 0.9 };
+    double ref[4] = { 0., 0., 0., 1. };
+    double orient[4], proj[16], persp[16], view[16], eye[3];
+    double pos[3] = { 0., 1.7, 0. };
+    int i;
+
+    quat_normalize(q, NULL);
+    mat4_perspective(90., 0.8, 0.1, 100., persp);
+
+    unsigned long allocs = gl_matrix_allocCount();
+    for( i = 0; i < 1000; i++ )
+    {
+        quat_set(q, orient);
+        quat_multiply(orient, ref, NULL);
+
+        mat4_identity(proj);
+        proj[12] = 0.15;
+        mat4_multiply(proj, persp, NULL);
+
+        eye[0] = -0.032; eye[1] = 0.15; eye[2] = 0.1;
+        quat_multiplyVec3(orient, eye, NULL);
+        vec3_add(eye, pos, NULL);
+
+        quat_toMat4(orient, view);
+        mat4_translate(view, eye, NULL);
+        mat4_inverse(view, NULL);
+    }
+    check(gl_matrix_allocCount() == allocs, "per-frame quat/mat math does not allocate");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Results gl_matrix creates itself: counted on the heap, never in an arena
+/////////////////////////////////////////////////////////////////////////////////////////////
+static void testCreate( void )
+{
+    double q[4] = { 0., 0., 0., 1. };
+    unsigned long allocs = gl_matrix_allocCount();
+
+    double *m = mat4_create(NULL);
+    double *r = quat_toMat4(q, NULL);
+
+#ifdef GL_MATRIX_ARENA
+    check(gl_matrix_allocCount() == allocs, "arena results do not reach the heap");
+    (void)m; (void)r;
+    gl_matrix_arenaReset();
+#else
+    check(gl_matrix_allocCount() == allocs + 2, "heap results are counted");
+    free(m);
+    free(r);
+#endif
+}
+
+int main( void )
+{
+    testFusion();
+    testFrameMath();
+    testCreate();
+
+    if( g_failures )
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}